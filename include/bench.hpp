@@ -0,0 +1,719 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_BENCH_HPP
+#define c6d28b7452ec699b_BENCH_HPP
+
+#include <cycle.h>
+#include <helpers.hpp>
+#include <stats.hpp>
+#include <bench_output.hpp>
+#include <perf_counters.hpp>
+#include <calibration.hpp>
+#include <preflight.hpp>
+#include <working_set.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Registry and runner for the benchmark binaries.
+ *
+ * Each variant registers a named kernel with a Runner, and the Runner owns the
+ * repetition loop, warmup, name filtering and result collection. A kernel is
+ * either a plain function that is timed as a whole, or a phased function that
+ * receives a Timer and brackets each of its phases with start()/stop(phase).
+ *
+ *	bench::Runner runner(argc, argv);
+ *	runner.n = N;
+ *	runner.add("atoi()", [&]() { ... });
+ *	runner.run();
+ *
+ * Runner::n is the number of operations one timed region performs, and is
+ * used for the per-op figures in the --json/--csv records. Kernels that
+ * perform fewer operations than there are elements, such as N/S range
+ * queries of S elements each, also set Runner::size to the data size.
+ *
+ * Benchmarks whose cost depends on the data size loop over runner.sizes(N)
+ * and register their kernels once per size; --sizes replaces the default N
+ * with a sweep, and curve() then prints ns/op per variant across the sizes.
+ *
+ *	for (size_t n : runner.sizes(100000)) {
+ *		runner.n = n;
+ *		... build n inputs, add() kernels, run() ...
+ *	}
+ *	runner.curve();
+ *
+ * The memory a kernel works on is runner.working_set bytes, or whatever the
+ * kernel measured and passed to Timer::working_set(); each data point is then
+ * annotated with the cache level that footprint fits in (see working_set.hpp).
+ *
+ * At startup the thread is pinned with --cpu, and the environment checked
+ * for anything that makes timings noisy (see preflight.hpp). Benchmarks
+ * whose kernels run worker threads call threaded(), so that leaving out
+ * --cpu isn't warned about. Then the tick rate is calibrated against the
+ * wall clock and the cost of an empty start()/stop() is measured; that
+ * overhead is subtracted from every region, and the per-op figures are also
+ * given in ns.
+ *
+ * With --perf the hardware counters from perf_counters.hpp are read at every
+ * start()/stop() as well, and their per-op medians are reported next to the
+ * ticks. They only count the main thread, so kernels that time worker
+ * threads call Timer::threaded() and report no counters.
+ */
+namespace bench {
+
+// Parses a size such as 1000, 64k, 2M or 2^20 (k, M and G are powers of 10)
+inline size_t parse_size(const std::string& str) {
+	size_t caret = str.find('^');
+	if (caret != std::string::npos) {
+		size_t base = parse_size(str.substr(0, caret));
+		size_t exp = parse_size(str.substr(caret + 1));
+		size_t rv = 1;
+		for (size_t i = 0; i < exp; ++i) {
+			rv *= base;
+		}
+		return rv;
+	}
+	char *end = 0;
+	size_t rv = std::strtoull(str.c_str(), &end, 10);
+	if (end == str.c_str()) {
+		throw std::invalid_argument("invalid size: " + str);
+	}
+	std::string suffix(end);
+	if (suffix == "k" || suffix == "K") {
+		rv *= 1000;
+	}
+	else if (suffix == "M") {
+		rv *= 1000000;
+	}
+	else if (suffix == "G") {
+		rv *= 1000000000;
+	}
+	else if (!suffix.empty()) {
+		throw std::invalid_argument("invalid size: " + str);
+	}
+	return rv;
+}
+
+// Parses a comma separated list of sizes and geometric ranges A..B[:F], where
+// F is the factor between steps (default 2), e.g. 2^6..2^27 or 100..100M:10
+inline std::vector<size_t> parse_sizes(const std::string& spec) {
+	std::vector<size_t> rv;
+	std::istringstream ss(spec);
+	std::string item;
+	while (std::getline(ss, item, ',')) {
+		size_t dots = item.find("..");
+		if (dots == std::string::npos) {
+			rv.push_back(parse_size(item));
+			continue;
+		}
+		std::string to = item.substr(dots + 2);
+		double factor = 2.0;
+		size_t colon = to.find(':');
+		if (colon != std::string::npos) {
+			factor = std::strtod(to.substr(colon + 1).c_str(), 0);
+			to = to.substr(0, colon);
+		}
+		size_t lo = parse_size(item.substr(0, dots));
+		size_t hi = parse_size(to);
+		if (!(factor > 1.0) || lo == 0 || lo > hi) {
+			throw std::invalid_argument("invalid size range: " + item);
+		}
+		for (double d = double(lo); d <= double(hi) * (1.0 + 1e-9); d *= factor) {
+			size_t v = size_t(d + 0.5);
+			if (rv.empty() || rv.back() != v) {
+				rv.push_back(v);
+			}
+		}
+	}
+	if (rv.empty()) {
+		throw std::invalid_argument("empty size list");
+	}
+	return rv;
+}
+
+// Keeps the optimizer from discarding a value that is otherwise never used
+template<typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__)
+	asm volatile ("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void *sink = 0;
+	sink = &value;
+#endif
+}
+
+class Timer {
+public:
+	std::vector< std::vector<double> > timings;
+	// Counter deltas per phase, parallel to timings; only filled with perf
+	std::vector< std::vector<PerfValues> > counters;
+	std::vector<double> footprints;
+
+	Timer(size_t phases = 1, const PerfCounters *perf = 0, double overhead = 0.0) : timings(phases), counters(phases), begin(), perf(perf), overhead(overhead) {
+	}
+
+	// Counters are read outside the ticked region so the reads don't inflate it
+	void start() {
+		if (perf) {
+			perf->read(perf_begin);
+		}
+		begin = getticks();
+	}
+
+	// The counters only count the thread that opened them, so a region whose
+	// work runs on other threads reports none rather than that thread waiting
+	void threaded() {
+		perf = 0;
+		for (size_t p = 0; p < counters.size(); ++p) {
+			counters[p].clear();
+		}
+	}
+
+	// Footprint of the data this repetition worked on, measured by the kernel
+	void working_set(size_t bytes) {
+		footprints.push_back(double(bytes));
+	}
+
+	void stop(size_t phase = 0) {
+		ticks end = getticks();
+		double t = elapsed(end, begin) - overhead;
+		timings[phase].push_back(t > 0.0 ? t : 0.0);
+		if (perf) {
+			PerfValues perf_end;
+			perf->read(perf_end);
+			counters[phase].push_back(perf_end - perf_begin);
+		}
+	}
+
+private:
+	ticks begin;
+	const PerfCounters *perf;
+	PerfValues perf_begin;
+	double overhead;
+};
+
+struct Kernel {
+	std::string name;
+	std::vector<std::string> phases;
+	size_t n;
+	size_t size;
+	size_t working_set;
+	std::vector< std::pair<std::string, double> > metrics;
+	std::function<void(Timer&)> fn;
+};
+
+struct Result {
+	std::string name;
+	std::string phase;
+	size_t n;
+	// Data size, which curve() groups by
+	size_t size;
+	std::vector<double> timings;
+	std::vector<PerfValues> counters;
+	double fastest;
+	// Bytes, 0 if unknown, and the cache level they fit in
+	size_t working_set;
+	std::string residency;
+	// Untimed figures attached with Runner::metric()
+	std::vector< std::pair<std::string, double> > metrics;
+
+	// Median of counter i over the repetitions, divided by n
+	double counter_per_op(size_t i) const {
+		std::vector<double> v;
+		for (size_t r = 0; r < counters.size(); ++r) {
+			if (std::isfinite(counters[r].v[i])) {
+				v.push_back(counters[r].v[i]);
+			}
+		}
+		return median(v) / double(n ? n : 1);
+	}
+
+	std::string label() const {
+		if (phase.empty()) {
+			return name;
+		}
+		return name + " " + phase;
+	}
+};
+
+class Runner {
+public:
+	std::string benchmark;
+	size_t repetitions;
+	size_t warmup;
+	std::string filter;
+	bool list;
+	size_t n;
+	// Data size the kernels registered from now on run at, if not n; 0 means n
+	size_t size;
+	// Samples further than this many scaled MADs from the median are dropped
+	// from the summaries; 0 keeps everything
+	double outliers;
+	// Adaptive mode: keep repeating until the median's 95% confidence interval
+	// is narrower than ci_target percent of the median, or max_repetitions
+	double ci_target;
+	size_t max_repetitions;
+	bool use_perf;
+	// CPU to pin to, or -1
+	int cpu;
+	bool fifo;
+	// Footprint in bytes of the data kernels registered from now on work on,
+	// unless they measure it themselves; 0 if unknown
+	size_t working_set;
+
+	Runner(int argc, char *argv[], size_t repetitions = 7, size_t warmup = 1)
+	  : repetitions(repetitions)
+	  , warmup(warmup)
+	  , list(false)
+	  , n(1)
+	  , size(0)
+	  , outliers(0.0)
+	  , ci_target(0.0)
+	  , max_repetitions(100)
+	  , use_perf(false)
+	  , cpu(-1)
+	  , fifo(false)
+	  , working_set(0)
+	  , multi_threaded(false)
+	  , pin_checked(false)
+	{
+		benchmark = argv[0];
+		size_t slash = benchmark.find_last_of("/\\");
+		if (slash != std::string::npos) {
+			benchmark = benchmark.substr(slash + 1);
+		}
+
+		for (int i = 1; i < argc; ++i) {
+			std::string arg = argv[i];
+			if ((arg == "-r" || arg == "--repetitions") && i + 1 < argc) {
+				this->repetitions = std::strtoul(argv[++i], 0, 10);
+			}
+			else if ((arg == "-w" || arg == "--warmup") && i + 1 < argc) {
+				this->warmup = std::strtoul(argv[++i], 0, 10);
+			}
+			else if ((arg == "-f" || arg == "--filter") && i + 1 < argc) {
+				filter = argv[++i];
+			}
+			else if (arg == "-l" || arg == "--list") {
+				list = true;
+			}
+			else if (arg == "--outliers" && i + 1 < argc) {
+				outliers = std::strtod(argv[++i], 0);
+			}
+			else if (arg == "--ci-target" && i + 1 < argc) {
+				ci_target = std::strtod(argv[++i], 0);
+			}
+			else if (arg == "--max-repetitions" && i + 1 < argc) {
+				max_repetitions = std::strtoul(argv[++i], 0, 10);
+			}
+			else if ((arg == "-n" || arg == "--sizes") && i + 1 < argc) {
+				try {
+					sweep = parse_sizes(argv[++i]);
+				}
+				catch (const std::exception& e) {
+					std::cerr << e.what() << std::endl;
+					std::exit(1);
+				}
+			}
+			else if ((arg == "-p" || arg == "--param") && i + 1 < argc) {
+				std::string kv = argv[++i];
+				size_t eq = kv.find('=');
+				if (eq == std::string::npos) {
+					usage(argv[0]);
+					std::exit(1);
+				}
+				params[kv.substr(0, eq)] = kv.substr(eq + 1);
+				writer.host.params += (writer.host.params.empty() ? "" : " ") + kv;
+			}
+			else if (arg == "--cpu" && i + 1 < argc) {
+				cpu = std::atoi(argv[++i]);
+			}
+			else if (arg == "--fifo") {
+				fifo = true;
+			}
+			else if (arg == "--perf") {
+				use_perf = true;
+			}
+			else if (arg == "--json" && i + 1 < argc) {
+				if (!writer.open_json(argv[++i])) {
+					std::cerr << "Could not open " << argv[i] << " for writing" << std::endl;
+					std::exit(1);
+				}
+			}
+			else if (arg == "--csv" && i + 1 < argc) {
+				std::string why;
+				if (!writer.open_csv(argv[++i], why)) {
+					std::cerr << why << std::endl;
+					std::exit(1);
+				}
+			}
+			else {
+				usage(argv[0]);
+				std::exit(arg == "-h" || arg == "--help" ? 0 : 1);
+			}
+		}
+		if (this->repetitions < 2) {
+			// PrintStats() needs at least two samples
+			this->repetitions = 2;
+		}
+		matcher = std::regex(filter);
+		if (!list) {
+			writer.host.env = preflight(cpu, fifo);
+			for (size_t w = 0; w < writer.host.env.warnings.size(); ++w) {
+				std::cerr << "Warning: " << writer.host.env.warnings[w] << std::endl;
+			}
+			calibrate();
+		}
+		caches = CacheInfo::detect(cpu);
+		writer.host.caches = caches.describe();
+		if (use_perf && !list && !perf.open()) {
+			std::cerr << "Warning: could not open any perf counters (check /proc/sys/kernel/perf_event_paranoid), continuing without" << std::endl;
+			use_perf = false;
+		}
+	}
+
+	static void usage(const char *self) {
+		std::cerr << "Usage: " << self << " [options]\n";
+		std::cerr << " -r, --repetitions N  timed runs per kernel\n";
+		std::cerr << " -w, --warmup N       untimed runs before the timed ones\n";
+		std::cerr << " -f, --filter REGEX   only run kernels whose name matches\n";
+		std::cerr << " -l, --list           list kernel names and exit\n";
+		std::cerr << "     --outliers K     drop samples more than K scaled MADs from the median\n";
+		std::cerr << "     --ci-target PCT  repeat until the 95% CI of the median is within PCT%\n";
+		std::cerr << "     --max-repetitions N  upper bound for --ci-target (default 100)\n";
+		std::cerr << " -n, --sizes LIST     run at these data sizes instead of the default, e.g. 2^6..2^27\n";
+		std::cerr << " -p, --param NAME=VAL benchmark specific setting, e.g. keys=zipf:0.99 for set\n";
+		std::cerr << "     --cpu N          pin to CPU N\n";
+		std::cerr << "     --fifo           run as SCHED_FIFO (needs CAP_SYS_NICE)\n";
+		std::cerr << "     --perf           also count instructions, cycles, branch and cache misses\n";
+		std::cerr << "     --json FILE      append results as JSON lines to FILE\n";
+		std::cerr << "     --csv FILE       append results as CSV rows to FILE\n";
+	}
+
+	// Registers a kernel that is timed as a whole
+	void add(const std::string& name, std::function<void()> fn) {
+		Kernel k;
+		k.name = name;
+		k.n = n;
+		k.size = size ? size : n;
+		k.working_set = working_set;
+		k.phases.push_back("");
+		k.fn = [fn](Timer& t) {
+			t.start();
+			fn();
+			t.stop();
+		};
+		kernels.push_back(k);
+	}
+
+	// Registers a kernel that times its own phases via Timer::start()/stop(phase)
+	void add(const std::string& name, const std::vector<std::string>& phases, std::function<void(Timer&)> fn) {
+		Kernel k;
+		k.name = name;
+		k.n = n;
+		k.size = size ? size : n;
+		k.working_set = working_set;
+		k.phases = phases;
+		k.fn = fn;
+		kernels.push_back(k);
+	}
+
+	// A benchmark specific --param, or deflt if not given
+	std::string param(const std::string& name, const std::string& deflt) const {
+		std::map<std::string, std::string>::const_iterator it = params.find(name);
+		if (it == params.end()) {
+			return deflt;
+		}
+		return it->second;
+	}
+
+	// Whether a kernel of that name would be run by --filter
+	bool selected(const std::string& name) const {
+		return std::regex_search(name, matcher);
+	}
+
+	// Attaches a named figure, e.g. memory use measured outside the timed
+	// runs, to the most recently added kernel's results and records
+	void metric(const std::string& name, double value) {
+		if (!kernels.empty()) {
+			kernels.back().metrics.push_back(std::make_pair(name, value));
+		}
+	}
+
+	// Declares that the kernels run worker threads, which --cpu would pin to
+	// the one CPU, so running unpinned is expected
+	void threaded() {
+		multi_threaded = true;
+	}
+
+	// Runs all kernels registered since the last call, in registration order
+	std::vector<Result> run() {
+		if (!list && !pin_checked) {
+			pin_checked = true;
+			if (cpu < 0 && !multi_threaded) {
+				Environment& env = writer.host.env;
+				size_t before = env.warnings.size();
+				warn_unpinned(env);
+				for (size_t w = before; w < env.warnings.size(); ++w) {
+					std::cerr << "Warning: " << env.warnings[w] << std::endl;
+				}
+			}
+		}
+		std::vector<Result> batch;
+		for (size_t i = 0; i < kernels.size(); ++i) {
+			const Kernel& k = kernels[i];
+			if (!selected(k.name)) {
+				continue;
+			}
+			if (list) {
+				std::cout << k.name << std::endl;
+				continue;
+			}
+
+			for (size_t r = 0; r < warmup; ++r) {
+				Timer t(k.phases.size());
+				k.fn(t);
+			}
+			Timer t(k.phases.size(), use_perf ? &perf : 0, clock.overhead);
+			for (size_t r = 0; r < repetitions; ++r) {
+				k.fn(t);
+			}
+			for (size_t r = repetitions; r < max_repetitions && !converged(t); ++r) {
+				k.fn(t);
+			}
+
+			for (size_t p = 0; p < k.phases.size(); ++p) {
+				Result res;
+				res.name = k.name;
+				res.phase = k.phases[p];
+				res.n = k.n;
+				res.size = k.size;
+				res.timings = t.timings[p];
+				res.counters = t.counters[p];
+				res.working_set = t.footprints.empty() ? k.working_set : size_t(median(t.footprints));
+				res.residency = caches.residency(res.working_set);
+				res.metrics = k.metrics;
+				if (res.timings.empty()) {
+					continue;
+				}
+
+				std::cout << res.label();
+				if (!sweep.empty()) {
+					std::cout << " n=" << res.n;
+				}
+				std::cout << ": ";
+				res.fastest = PrintStats(res.timings);
+				Summary sum = summarize(res.timings, outliers);
+				std::cout << ", CI95 +-" << sum.ci_width() / 2.0 << "%";
+				std::cout << ", " << clock.to_ns(sum.median) / double(res.n ? res.n : 1) << " ns/op";
+				if (res.working_set) {
+					std::cout << ", " << format_bytes(res.working_set);
+					if (!res.residency.empty()) {
+						std::cout << " (" << res.residency << ")";
+					}
+				}
+				if (sum.outliers) {
+					std::cout << ", " << sum.outliers << " outliers";
+				}
+				std::cout << std::endl;
+				if (!res.counters.empty()) {
+					print_counters(res);
+				}
+				record(res);
+
+				batch.push_back(res);
+			}
+		}
+		kernels.clear();
+		results.insert(results.end(), batch.begin(), batch.end());
+		return batch;
+	}
+
+	// The sizes to run at: the --sizes sweep if given, otherwise just deflt
+	std::vector<size_t> sizes(size_t deflt) const {
+		if (sweep.empty()) {
+			return std::vector<size_t>(1, deflt);
+		}
+		return sweep;
+	}
+
+	// Prints median ns/op of every variant and phase across the sizes run,
+	// one row per variant, if more than one size was run. Each cell is
+	// annotated with the cache level its working set fits in, if known.
+	void curve() const {
+		std::vector<size_t> ns;
+		std::vector<std::string> labels;
+		std::map< std::string, std::map<size_t, const Result*> > cells;
+		for (size_t i = 0; i < results.size(); ++i) {
+			const Result& res = results[i];
+			if (std::find(ns.begin(), ns.end(), res.size) == ns.end()) {
+				ns.push_back(res.size);
+			}
+			if (cells.find(res.label()) == cells.end()) {
+				labels.push_back(res.label());
+			}
+			cells[res.label()][res.size] = &res;
+		}
+		if (ns.size() < 2) {
+			return;
+		}
+		std::sort(ns.begin(), ns.end());
+
+		std::cout << std::endl << "ns/op";
+		for (size_t i = 0; i < ns.size(); ++i) {
+			std::cout << "\t" << ns[i];
+		}
+		std::cout << std::endl;
+		std::cout << std::fixed << std::setprecision(2);
+		for (size_t l = 0; l < labels.size(); ++l) {
+			const std::map<size_t, const Result*>& row = cells[labels[l]];
+			std::cout << labels[l];
+			for (size_t i = 0; i < ns.size(); ++i) {
+				std::cout << "\t";
+				std::map<size_t, const Result*>::const_iterator it = row.find(ns[i]);
+				if (it != row.end()) {
+					const Result& res = *it->second;
+					std::cout << clock.to_ns(median(res.timings)) / double(res.n ? res.n : 1);
+					if (!res.residency.empty()) {
+						std::cout << " " << res.residency;
+					}
+				}
+			}
+			std::cout << std::endl;
+		}
+	}
+
+	const std::vector<Result>& all() const {
+		return results;
+	}
+
+	const Host& host() const {
+		return writer.host;
+	}
+
+	const Clock& calibration() const {
+		return clock;
+	}
+
+	// Sends a result to the --json/--csv sinks, if any
+	void record(const Result& res) {
+		if (!writer.active()) {
+			return;
+		}
+		Record rec;
+		rec.benchmark = benchmark;
+		rec.variant = res.name;
+		rec.phase = res.phase;
+		rec.n = res.n;
+		rec.repetitions = res.timings.size();
+		rec.summary = summarize(res.timings, outliers);
+		rec.per_op = rec.summary.min / double(res.n ? res.n : 1);
+		rec.ns_per_op = clock.to_ns(rec.summary.median) / double(res.n ? res.n : 1);
+		rec.working_set = res.working_set;
+		rec.residency = res.residency;
+		rec.metrics = res.metrics;
+		rec.samples = res.timings;
+		for (size_t i = 0; i < PERF_NUM && !res.counters.empty(); ++i) {
+			rec.counters.v[i] = res.counter_per_op(i);
+		}
+		writer.write(rec);
+	}
+
+private:
+	void calibrate() {
+		clock = Clock::calibrate();
+		writer.host.ns_per_tick = clock.ns_per_tick;
+		writer.host.timer_overhead = clock.overhead;
+		writer.host.timer_resolution = clock.resolution;
+		writer.host.tsc = !clock.tsc_checked ? "unknown" : (clock.tsc_invariant ? "invariant" : "variant");
+		if (clock.tsc_checked && !clock.tsc_invariant) {
+			std::cerr << "Warning: TSC is not invariant (constant_tsc/nonstop_tsc missing), ticks may not be comparable" << std::endl;
+		}
+		if (clock.drift > 0.01) {
+			std::cerr << "Warning: tick rate varied by " << clock.drift * 100.0 << "% during calibration" << std::endl;
+		}
+		if (clock.resolution > clock.overhead) {
+			std::cerr << "Warning: timer resolution is " << clock.to_ns(clock.resolution) << " ns, coarser than an empty region, so short regions are rounded" << std::endl;
+		}
+	}
+
+	void print_counters(const Result& res) const {
+		std::cout << "\tper op:";
+		const char *sep = " ";
+		for (size_t i = 0; i < PERF_NUM; ++i) {
+			double d = res.counter_per_op(i);
+			if (std::isfinite(d)) {
+				std::cout << sep << d << " " << perf_name(i);
+				sep = ", ";
+			}
+		}
+		double ipc = res.counter_per_op(PERF_INSTRUCTIONS) / res.counter_per_op(PERF_CYCLES);
+		if (std::isfinite(ipc)) {
+			std::cout << sep << "IPC " << ipc;
+		}
+		std::cout << std::endl;
+	}
+
+	// True once every phase's confidence interval is within ci_target
+	bool converged(const Timer& t) const {
+		if (!(ci_target > 0.0)) {
+			return true;
+		}
+		for (size_t p = 0; p < t.timings.size(); ++p) {
+			if (t.timings[p].empty()) {
+				continue;
+			}
+			if (!(summarize(t.timings[p], outliers).ci_width() <= ci_target)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<size_t> sweep;
+	std::map<std::string, std::string> params;
+	ResultWriter writer;
+	Clock clock;
+	CacheInfo caches;
+	PerfCounters perf;
+	std::regex matcher;
+	std::vector<Kernel> kernels;
+	std::vector<Result> results;
+	bool multi_threaded;
+	bool pin_checked;
+};
+
+}
+
+#endif
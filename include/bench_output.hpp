@@ -0,0 +1,366 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_BENCH_OUTPUT_HPP
+#define c6d28b7452ec699b_BENCH_OUTPUT_HPP
+
+#include <stats.hpp>
+#include <perf_counters.hpp>
+#include <preflight.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifndef _MSC_VER
+	#include <unistd.h>
+	#include <sys/utsname.h>
+#endif
+
+/*
+ * Structured result sinks. Every measured phase becomes one record, written
+ * as a JSON object per line and/or a CSV row, so results can be collected
+ * without scraping the human readable PrintStats() output.
+ */
+namespace bench {
+
+struct Host {
+	std::string hostname;
+	std::string os;
+	std::string cpu;
+	std::string compiler;
+	unsigned cpus;
+	std::string timestamp;
+	// Filled in by the Runner's clock calibration
+	double ns_per_tick;
+	double timer_overhead;
+	double timer_resolution;
+	std::string tsc;
+	// Filled in by the Runner's preflight
+	Environment env;
+	// The --param settings, space separated NAME=VALUE
+	std::string params;
+	// Data cache sizes, e.g. "L1 48.0 KiB, L2 2.0 MiB, L3 105.0 MiB"
+	std::string caches;
+
+	Host() : cpus(0), ns_per_tick(std::numeric_limits<double>::quiet_NaN()), timer_overhead(0.0), timer_resolution(0.0), tsc("unknown") {
+	}
+
+	static Host detect() {
+		Host h;
+		h.cpus = std::thread::hardware_concurrency();
+
+#ifdef _MSC_VER
+		if (const char *name = std::getenv("COMPUTERNAME")) {
+			h.hostname = name;
+		}
+		h.os = "Windows";
+		h.compiler = "MSVC " + std::to_string(_MSC_FULL_VER);
+#else
+		char name[256] = {};
+		if (gethostname(name, sizeof(name) - 1) == 0) {
+			h.hostname = name;
+		}
+		struct utsname un;
+		if (uname(&un) == 0) {
+			h.os = std::string(un.sysname) + " " + un.release + " " + un.machine;
+		}
+	#if defined(__clang__)
+		h.compiler = "Clang " __clang_version__;
+	#elif defined(__GNUC__)
+		h.compiler = "GCC " __VERSION__;
+	#endif
+#endif
+
+		std::ifstream cpuinfo("/proc/cpuinfo");
+		std::string line;
+		while (std::getline(cpuinfo, line)) {
+			if (line.compare(0, 10, "model name") == 0) {
+				size_t colon = line.find(':');
+				if (colon != std::string::npos) {
+					h.cpu = line.substr(line.find_first_not_of(' ', colon + 1));
+				}
+				break;
+			}
+		}
+
+		char buf[32] = {};
+		std::time_t now = std::time(0);
+		std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+		h.timestamp = buf;
+		return h;
+	}
+};
+
+// One measured phase of one kernel
+struct Record {
+	std::string benchmark;
+	std::string variant;
+	std::string phase;
+	size_t n;
+	size_t repetitions;
+	Summary summary;
+	double per_op;
+	// Median in ns per op, via the calibrated tick rate
+	double ns_per_op;
+	// Footprint in bytes (0 if unknown) and the cache level it fits in
+	size_t working_set;
+	std::string residency;
+	// Per-op hardware counter medians, NaN when not measured
+	PerfValues counters;
+	// Named figures the benchmark measured outside the timed runs
+	std::vector< std::pair<std::string, double> > metrics;
+	std::vector<double> samples;
+};
+
+inline std::string json_escape(const std::string& str) {
+	std::string rv;
+	for (size_t i = 0; i < str.size(); ++i) {
+		unsigned char c = static_cast<unsigned char>(str[i]);
+		if (c == '"' || c == '\\') {
+			rv += '\\';
+			rv += c;
+		}
+		else if (c < 0x20) {
+			char esc[8];
+			snprintf(esc, sizeof(esc), "\\u%04x", c);
+			rv += esc;
+		}
+		else {
+			rv += c;
+		}
+	}
+	return rv;
+}
+
+inline std::string csv_escape(const std::string& str) {
+	if (str.find_first_of(",\"\n") == std::string::npos) {
+		return str;
+	}
+	std::string rv = "\"";
+	for (size_t i = 0; i < str.size(); ++i) {
+		if (str[i] == '"') {
+			rv += '"';
+		}
+		rv += str[i];
+	}
+	rv += '"';
+	return rv;
+}
+
+inline bool has_counters(const PerfValues& pv) {
+	for (size_t i = 0; i < PERF_NUM; ++i) {
+		if (std::isfinite(pv.v[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Writes numbers so that NaN/inf still yield valid JSON
+inline void json_number(std::ostream& out, double d) {
+	if (std::isfinite(d)) {
+		out << d;
+	}
+	else {
+		out << "null";
+	}
+}
+
+class ResultWriter {
+public:
+	ResultWriter() : host(Host::detect()) {
+	}
+
+	bool open_json(const std::string& fname) {
+		json.open(fname.c_str(), std::ios::binary | std::ios::app);
+		return json.is_open();
+	}
+
+	// Appends to fname, writing the header if the file is new. A file whose
+	// header differs was written by a build with other columns, and appending
+	// would put rows under the wrong names, so that fails with why set.
+	bool open_csv(const std::string& fname, std::string& why) {
+		const std::string header = "benchmark,variant,phase,n,repetitions,outliers,min,p5,median,mean,stddev,p95,mad,ci_lo,ci_hi,per_op,ns_per_op,working_set,residency,instructions,cycles,branch_misses,l1d_misses,llc_misses,dtlb_misses,hostname,os,cpu,compiler,cpus,timestamp,ns_per_tick,timer_overhead,timer_resolution,tsc,pinned_cpu,scheduler,governor,turbo,smt,siblings,warnings,caches,params,metrics,samples";
+		std::string existing;
+		{
+			std::ifstream probe(fname.c_str(), std::ios::binary);
+			std::getline(probe, existing);
+		}
+		if (!existing.empty() && existing != header) {
+			why = fname + " has other CSV columns than this build writes, use a new file";
+			return false;
+		}
+		csv.open(fname.c_str(), std::ios::binary | std::ios::app);
+		if (!csv.is_open()) {
+			why = "Could not open " + fname + " for writing";
+			return false;
+		}
+		if (existing.empty()) {
+			csv << header << "\n";
+		}
+		return true;
+	}
+
+	bool active() const {
+		return json.is_open() || csv.is_open();
+	}
+
+	void write(const Record& r) {
+		if (json.is_open()) {
+			write_json(r);
+		}
+		if (csv.is_open()) {
+			write_csv(r);
+		}
+	}
+
+	Host host;
+
+private:
+	std::ofstream json;
+	std::ofstream csv;
+
+	void write_json(const Record& r) {
+		std::ostringstream out;
+		out << std::setprecision(15);
+		out << "{\"benchmark\":\"" << json_escape(r.benchmark) << "\"";
+		out << ",\"variant\":\"" << json_escape(r.variant) << "\"";
+		out << ",\"phase\":\"" << json_escape(r.phase) << "\"";
+		out << ",\"n\":" << r.n;
+		out << ",\"repetitions\":" << r.repetitions;
+		out << ",\"outliers\":" << r.summary.outliers;
+		out << ",\"min\":"; json_number(out, r.summary.min);
+		out << ",\"p5\":"; json_number(out, r.summary.p5);
+		out << ",\"median\":"; json_number(out, r.summary.median);
+		out << ",\"mean\":"; json_number(out, r.summary.mean);
+		out << ",\"stddev\":"; json_number(out, r.summary.stddev);
+		out << ",\"p95\":"; json_number(out, r.summary.p95);
+		out << ",\"mad\":"; json_number(out, r.summary.mad);
+		out << ",\"ci_lo\":"; json_number(out, r.summary.ci_lo);
+		out << ",\"ci_hi\":"; json_number(out, r.summary.ci_hi);
+		out << ",\"per_op\":"; json_number(out, r.per_op);
+		out << ",\"ns_per_op\":"; json_number(out, r.ns_per_op);
+		out << ",\"working_set\":" << r.working_set;
+		out << ",\"residency\":\"" << r.residency << "\"";
+		out << ",\"unit\":\"ticks\"";
+		if (has_counters(r.counters)) {
+			out << ",\"counters\":{";
+			for (size_t i = 0; i < PERF_NUM; ++i) {
+				out << (i ? ",\"" : "\"") << perf_name(i) << "\":";
+				json_number(out, r.counters.v[i]);
+			}
+			out << "}";
+		}
+		if (!r.metrics.empty()) {
+			out << ",\"metrics\":{";
+			for (size_t i = 0; i < r.metrics.size(); ++i) {
+				out << (i ? ",\"" : "\"") << json_escape(r.metrics[i].first) << "\":";
+				json_number(out, r.metrics[i].second);
+			}
+			out << "}";
+		}
+		out << ",\"host\":{\"hostname\":\"" << json_escape(host.hostname) << "\"";
+		out << ",\"os\":\"" << json_escape(host.os) << "\"";
+		out << ",\"cpu\":\"" << json_escape(host.cpu) << "\"";
+		out << ",\"compiler\":\"" << json_escape(host.compiler) << "\"";
+		out << ",\"cpus\":" << host.cpus;
+		out << ",\"timestamp\":\"" << host.timestamp << "\"";
+		out << ",\"ns_per_tick\":"; json_number(out, host.ns_per_tick);
+		out << ",\"timer_overhead\":"; json_number(out, host.timer_overhead);
+		out << ",\"timer_resolution\":"; json_number(out, host.timer_resolution);
+		out << ",\"tsc\":\"" << host.tsc << "\"";
+		out << ",\"pinned_cpu\":" << host.env.cpu;
+		out << ",\"scheduler\":\"" << host.env.scheduler << "\"";
+		out << ",\"governor\":\"" << json_escape(host.env.governor) << "\"";
+		out << ",\"turbo\":\"" << host.env.turbo << "\"";
+		out << ",\"smt\":\"" << host.env.smt << "\"";
+		out << ",\"siblings\":\"" << json_escape(host.env.siblings) << "\"";
+		out << ",\"warnings\":[";
+		for (size_t i = 0; i < host.env.warnings.size(); ++i) {
+			out << (i ? ",\"" : "\"") << json_escape(host.env.warnings[i]) << "\"";
+		}
+		out << "]";
+		out << ",\"caches\":\"" << json_escape(host.caches) << "\"";
+		out << ",\"params\":\"" << json_escape(host.params) << "\"}";
+		out << ",\"samples\":[";
+		for (size_t i = 0; i < r.samples.size(); ++i) {
+			if (i) {
+				out << ",";
+			}
+			json_number(out, r.samples[i]);
+		}
+		out << "]}\n";
+		json << out.str();
+		json.flush();
+	}
+
+	void write_csv(const Record& r) {
+		std::ostringstream out;
+		out << std::setprecision(15);
+		out << csv_escape(r.benchmark) << "," << csv_escape(r.variant) << "," << csv_escape(r.phase);
+		out << "," << r.n << "," << r.repetitions << "," << r.summary.outliers;
+		out << "," << r.summary.min << "," << r.summary.p5 << "," << r.summary.median << "," << r.summary.mean;
+		out << "," << r.summary.stddev << "," << r.summary.p95 << "," << r.summary.mad;
+		out << "," << r.summary.ci_lo << "," << r.summary.ci_hi << "," << r.per_op << "," << r.ns_per_op;
+		out << "," << r.working_set << "," << r.residency;
+		for (size_t i = 0; i < PERF_NUM; ++i) {
+			out << ",";
+			if (std::isfinite(r.counters.v[i])) {
+				out << r.counters.v[i];
+			}
+		}
+		out << "," << csv_escape(host.hostname) << "," << csv_escape(host.os) << "," << csv_escape(host.cpu);
+		out << "," << csv_escape(host.compiler) << "," << host.cpus << "," << host.timestamp;
+		out << "," << host.ns_per_tick << "," << host.timer_overhead << "," << host.timer_resolution << "," << host.tsc;
+		out << "," << host.env.cpu << "," << host.env.scheduler << "," << csv_escape(host.env.governor);
+		out << "," << host.env.turbo << "," << host.env.smt << "," << csv_escape(host.env.siblings) << ",";
+		std::string warnings;
+		for (size_t i = 0; i < host.env.warnings.size(); ++i) {
+			warnings += (i ? "; " : "") + host.env.warnings[i];
+		}
+		out << csv_escape(warnings) << "," << csv_escape(host.caches) << "," << csv_escape(host.params) << ",";
+		for (size_t i = 0; i < r.metrics.size(); ++i) {
+			out << (i ? " " : "") << csv_escape(r.metrics[i].first) << "=" << r.metrics[i].second;
+		}
+		out << ",";
+		for (size_t i = 0; i < r.samples.size(); ++i) {
+			if (i) {
+				out << " ";
+			}
+			out << r.samples[i];
+		}
+		out << "\n";
+		csv << out.str();
+		csv.flush();
+	}
+};
+
+}
+
+#endif
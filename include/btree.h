@@ -102,6 +102,7 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
 #include <algorithm>
@@ -109,16 +110,27 @@
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <type_traits>
 #include <new>
 #include <ostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #ifndef NDEBUG
 #define NDEBUG 1
 #endif
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define BTREE_SIMD_X86 1
+	#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <xmmintrin.h>
+#endif
+
 #if defined(_MSC_VER)
 	#include <BaseTsd.h>
 	typedef SSIZE_T ssize_t;
@@ -157,6 +169,12 @@ struct big_ {
   char dummy[2];
 };
 
+// Tag selecting the constructors that bulk load from sorted input instead of
+// inserting one value at a time. See btree::bulk_load().
+struct sorted_input_t {
+};
+const sorted_input_t sorted_input = sorted_input_t();
+
 // A compile-time assertion.
 template <bool>
 struct CompileAssert {
@@ -272,8 +290,57 @@ static bool btree_compare_keys(
   return key_comparer::bool_compare(comp, x, y);
 }
 
+// Search policies for finding a key within a node, selected by the
+// SearchPolicy template parameter of the params structures (and of btree_set
+// and btree_multiset). The default uses linear search for arithmetic keys and
+// binary search otherwise. btree_simd_search counts the smaller keys with
+// SSE4.2/AVX2 compares, chosen at runtime, for sets of 32 and 64 bit integer
+// keys ordered by std::less, and falls back to the default for all others.
+struct btree_default_search {};
+struct btree_linear_search {};
+struct btree_binary_search {};
+struct btree_simd_search {};
+
+// Prefetch policies, selected by the template parameter after the search
+// policy. btree_prefetch requests every cache line of a node's values as soon
+// as a descent or an iterator knows the node's address, so that the misses
+// within a node overlap instead of following one another, and iteration
+// requests the next leaf while still scanning the current one.
+struct btree_no_prefetch {
+  static void prefetch(const void*, size_t) {}
+};
+
+struct btree_prefetch {
+  enum { kCacheLineSize = 64 };
+
+  static void prefetch(const void *p, size_t bytes) {
+    const char *b = static_cast<const char*>(p);
+    const char *e = b + bytes;
+    b -= reinterpret_cast<uintptr_t>(b) % kCacheLineSize;
+    for (; b < e; b += kCacheLineSize) {
+#if defined(__GNUC__)
+      __builtin_prefetch(b);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+      _mm_prefetch(b, _MM_HINT_T0);
+#endif
+    }
+  }
+};
+
+// Lets clear() hand every node back to the allocator at once. owns_all()
+// returns true when nothing but this tree holds memory from the allocator, and
+// release() then frees all of it without the tree visiting each node. See
+// btree_arena.h for the allocator that specializes this.
+template <typename Alloc>
+struct btree_bulk_release {
+  static bool owns_all(const Alloc&) { return false; }
+  static void release(Alloc&) {}
+};
+
 template <typename Key, typename Compare,
-          typename Alloc, int TargetNodeSize, int ValueSize>
+          typename Alloc, int TargetNodeSize, int ValueSize,
+          typename SearchPolicy = btree_default_search,
+          typename PrefetchPolicy = btree_no_prefetch>
 struct btree_common_params {
   // If Compare is derived from btree_key_compare_to_tag then use it as the
   // key_compare type. Otherwise, use btree_key_compare_to_adapter<> which will
@@ -287,6 +354,8 @@ struct btree_common_params {
 
   typedef Alloc allocator_type;
   typedef Key key_type;
+  typedef SearchPolicy search_policy;
+  typedef PrefetchPolicy prefetch_policy;
   typedef ssize_t size_type;
   typedef ptrdiff_t difference_type;
 
@@ -308,10 +377,13 @@ struct btree_common_params {
 
 // A parameters structure for holding the type parameters for a btree_map.
 template <typename Key, typename Data, typename Compare,
-          typename Alloc, int TargetNodeSize>
+          typename Alloc, int TargetNodeSize,
+          typename SearchPolicy = btree_default_search,
+          typename PrefetchPolicy = btree_no_prefetch>
 struct btree_map_params
     : public btree_common_params<Key, Compare, Alloc, TargetNodeSize,
-                                 sizeof(Key) + sizeof(Data)> {
+                                 sizeof(Key) + sizeof(Data), SearchPolicy,
+                                 PrefetchPolicy> {
   typedef Data data_type;
   typedef Data mapped_type;
   typedef std::pair<const Key, data_type> value_type;
@@ -334,10 +406,12 @@ struct btree_map_params
 };
 
 // A parameters structure for holding the type parameters for a btree_set.
-template <typename Key, typename Compare, typename Alloc, int TargetNodeSize>
+template <typename Key, typename Compare, typename Alloc, int TargetNodeSize,
+          typename SearchPolicy = btree_default_search,
+          typename PrefetchPolicy = btree_no_prefetch>
 struct btree_set_params
     : public btree_common_params<Key, Compare, Alloc, TargetNodeSize,
-                                 sizeof(Key)> {
+                                 sizeof(Key), SearchPolicy, PrefetchPolicy> {
   typedef std::false_type data_type;
   typedef std::false_type mapped_type;
   typedef Key value_type;
@@ -425,6 +499,137 @@ struct btree_binary_search_compare_to {
   }
 };
 
+// The SIMD instruction sets btree_simd_search can use on this CPU.
+enum {
+  BTREE_SIMD_NONE,
+  BTREE_SIMD_SSE42,
+  BTREE_SIMD_AVX2,
+};
+
+inline int btree_simd_level() {
+#ifdef BTREE_SIMD_X86
+  static const int level =
+      __builtin_cpu_supports("avx2") ? BTREE_SIMD_AVX2 :
+      __builtin_cpu_supports("sse4.2") ? BTREE_SIMD_SSE42 : BTREE_SIMD_NONE;
+  return level;
+#else
+  return BTREE_SIMD_NONE;
+#endif
+}
+
+// Returns how many of the n sorted keys are less than k, or not greater than
+// k if Upper. Counting every key instead of stopping at the first match keeps
+// the loop free of data dependent branches, which is what makes the SIMD
+// versions below pay off.
+template <bool Upper, typename K>
+inline int btree_scalar_rank(const K *keys, int n, K k) {
+  int rank = 0;
+  for (int i = 0; i < n; ++i) {
+    rank += Upper ? !(k < keys[i]) : (keys[i] < k);
+  }
+  return rank;
+}
+
+#ifdef BTREE_SIMD_X86
+// The SSE/AVX2 compares are signed only, so unsigned keys get their sign bit
+// flipped on both sides of the comparison first. Lower bounds count the keys
+// below k, upper bounds subtract the keys above k from n.
+template <bool Upper, typename K>
+__attribute__((target("sse4.2")))
+int btree_sse42_rank(const K *keys, int n, K k) {
+  const bool wide = sizeof(K) == 8;
+  const int lanes = 16 / sizeof(K);
+  const int64_t flip = std::is_signed<K>::value ? 0 :
+      (wide ? std::numeric_limits<int64_t>::min() : int64_t(1) << 31);
+  const __m128i flipv =
+      wide ? _mm_set1_epi64x(flip) : _mm_set1_epi32(int32_t(flip));
+  const __m128i kv = _mm_xor_si128(
+      wide ? _mm_set1_epi64x(int64_t(k)) : _mm_set1_epi32(int32_t(k)), flipv);
+  int count = 0;
+  int i = 0;
+  for (; i + lanes <= n; i += lanes) {
+    __m128i v = _mm_xor_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), flipv);
+    __m128i m;
+    if (wide) {
+      m = Upper ? _mm_cmpgt_epi64(v, kv) : _mm_cmpgt_epi64(kv, v);
+    } else {
+      m = Upper ? _mm_cmpgt_epi32(v, kv) : _mm_cmpgt_epi32(kv, v);
+    }
+    count += __builtin_popcount(_mm_movemask_epi8(m)) / int(sizeof(K));
+  }
+  int rank = Upper ? i - count : count;
+  return rank + btree_scalar_rank<Upper>(keys + i, n - i, k);
+}
+
+template <bool Upper, typename K>
+__attribute__((target("avx2")))
+int btree_avx2_rank(const K *keys, int n, K k) {
+  const bool wide = sizeof(K) == 8;
+  const int lanes = 32 / sizeof(K);
+  const int64_t flip = std::is_signed<K>::value ? 0 :
+      (wide ? std::numeric_limits<int64_t>::min() : int64_t(1) << 31);
+  const __m256i flipv =
+      wide ? _mm256_set1_epi64x(flip) : _mm256_set1_epi32(int32_t(flip));
+  const __m256i kv = _mm256_xor_si256(
+      wide ? _mm256_set1_epi64x(int64_t(k)) : _mm256_set1_epi32(int32_t(k)), flipv);
+  int count = 0;
+  int i = 0;
+  for (; i + lanes <= n; i += lanes) {
+    __m256i v = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flipv);
+    __m256i m;
+    if (wide) {
+      m = Upper ? _mm256_cmpgt_epi64(v, kv) : _mm256_cmpgt_epi64(kv, v);
+    } else {
+      m = Upper ? _mm256_cmpgt_epi32(v, kv) : _mm256_cmpgt_epi32(kv, v);
+    }
+    count += __builtin_popcount(_mm256_movemask_epi8(m)) / int(sizeof(K));
+  }
+  int rank = Upper ? i - count : count;
+  return rank + btree_scalar_rank<Upper>(keys + i, n - i, k);
+}
+#endif
+
+template <bool Upper, typename K>
+inline int btree_simd_rank(const K *keys, int n, K k) {
+#ifdef BTREE_SIMD_X86
+  switch (btree_simd_level()) {
+    case BTREE_SIMD_AVX2:
+      return btree_avx2_rank<Upper>(keys, n, k);
+    case BTREE_SIMD_SSE42:
+      return btree_sse42_rank<Upper>(keys, n, k);
+  }
+#endif
+  return btree_scalar_rank<Upper>(keys, n, k);
+}
+
+// Whether btree_simd_search applies: a set (the node's values are its keys)
+// of 32 or 64 bit integers under std::less.
+template <typename Params>
+struct btree_simd_searchable {
+  typedef typename Params::key_type key_type;
+  enum {
+    value = std::is_integral<key_type>::value &&
+        (sizeof(key_type) == 4 || sizeof(key_type) == 8) &&
+        int(Params::kValueSize) == int(sizeof(key_type)) &&
+        std::is_base_of<std::less<key_type>,
+                        typename Params::key_compare>::value,
+  };
+};
+
+// Dispatch helper class for using SIMD search. The comparator is known to be
+// std::less and is not needed.
+template <typename K, typename N, typename Compare>
+struct btree_simd_search_plain_compare {
+  static int lower_bound(const K &k, const N &n, Compare)  {
+    return btree_simd_rank<false>(&n.key(0), n.count(), k);
+  }
+  static int upper_bound(const K &k, const N &n, Compare)  {
+    return btree_simd_rank<true>(&n.key(0), n.count(), k);
+  }
+};
+
 // A node in the btree holding. The same node type is used for both internal
 // and leaf nodes in the btree, though the nodes are allocated in such a way
 // that the children array is only valid in internal nodes.
@@ -471,7 +676,22 @@ class btree_node {
   typedef typename if_<
     std::is_integral<key_type>::value ||
     std::is_floating_point<key_type>::value,
-    linear_search_type, binary_search_type>::type search_type;
+    linear_search_type, binary_search_type>::type default_search_type;
+  typedef btree_simd_search_plain_compare<
+    key_type, self_type, key_compare> simd_search_type;
+  // The search Params::search_policy asks for, where it applies.
+  typedef typename Params::search_policy search_policy;
+  typedef typename if_<
+    std::is_same<search_policy, btree_linear_search>::value,
+    linear_search_type,
+    typename if_<
+      std::is_same<search_policy, btree_binary_search>::value,
+      binary_search_type,
+      typename if_<
+        std::is_same<search_policy, btree_simd_search>::value &&
+        btree_simd_searchable<Params>::value,
+        simd_search_type,
+        default_search_type>::type>::type>::type search_type;
 
   struct base_fields {
     typedef typename Params::node_count_type field_type;
@@ -573,6 +793,13 @@ class btree_node {
     params_type::swap(mutable_value(i), x->mutable_value(j));
   }
 
+  // Requests the cache lines holding node n's fields and values, if the
+  // prefetch policy asks for that. An internal node's children are left out,
+  // only the one the search picks is read.
+  static void prefetch(const btree_node *n) {
+    params_type::prefetch_policy::prefetch(n, sizeof(leaf_fields));
+  }
+
   // Getters/setter for the child at position i in the node.
   btree_node* child(int i) const { return fields_.children[i]; }
   btree_node** mutable_child(int i) { return &fields_.children[i]; }
@@ -878,6 +1105,8 @@ class btree : public Params::key_compare {
     kValueSize = node_type::kValueSize,
     kExactMatch = node_type::kExactMatch,
     kMatchMask = node_type::kMatchMask,
+    // The number of lookups find_unique_batch() advances together.
+    kFindBatch = 16,
   };
 
   // A helper class to get the empty base class optimization for 0-size
@@ -930,8 +1159,8 @@ class btree : public Params::key_compare {
   typedef std::reverse_iterator<iterator> reverse_iterator;
 
   typedef typename Params::allocator_type allocator_type;
-  typedef typename allocator_type::template rebind<char>::other
-    internal_allocator_type;
+  typedef typename std::allocator_traits<allocator_type>::template
+    rebind_alloc<char> internal_allocator_type;
 
  public:
   // Default constructor.
@@ -1047,6 +1276,14 @@ class btree : public Params::key_compare {
   template <typename InputIterator>
   void insert_multi(InputIterator b, InputIterator e);
 
+  // Replaces the contents of the btree with the values in [b, e), which must
+  // already be sorted (and free of duplicates for the unique containers). The
+  // tree is built bottom-up in linear time without any key comparisons or
+  // node splits, with every node filled to about fill times its capacity. A
+  // fill below 1 leaves room for later inserts to land without splitting.
+  template <typename ForwardIterator>
+  void bulk_load(ForwardIterator b, ForwardIterator e, double fill = 1.0);
+
   void assign(const self_type &x);
 
   // Erase the specified iterator from the btree. The iterator must be valid
@@ -1075,6 +1312,37 @@ class btree : public Params::key_compare {
     return internal_end(
         internal_find_unique(key, const_iterator(root(), 0)));
   }
+  // Looks up every key in [b, e) like find_unique() and writes the results to
+  // out in order. Up to kFindBatch lookups descend the tree together, one
+  // level at a time, and each prefetches its next node before the others
+  // search theirs, so their cache misses overlap instead of following one
+  // another.
+  template <typename ForwardIterator, typename OutputIterator>
+  OutputIterator find_unique_batch(
+      ForwardIterator b, ForwardIterator e, OutputIterator out) {
+    iterator found[kFindBatch];
+    while (b != e) {
+      int n = internal_find_unique_batch(b, e, found, iterator(root(), 0));
+      for (int i = 0; i < n; ++i) {
+        *out++ = internal_end(found[i]);
+      }
+    }
+    return out;
+  }
+  template <typename ForwardIterator, typename OutputIterator>
+  OutputIterator find_unique_batch(
+      ForwardIterator b, ForwardIterator e, OutputIterator out) const {
+    const_iterator found[kFindBatch];
+    while (b != e) {
+      int n = internal_find_unique_batch(
+          b, e, found, const_iterator(root(), 0));
+      for (int i = 0; i < n; ++i) {
+        *out++ = internal_end(found[i]);
+      }
+    }
+    return out;
+  }
+
   iterator find_multi(const key_type &key) {
     return internal_end(
         internal_find_multi(key, iterator(root(), 0)));
@@ -1356,9 +1624,21 @@ class btree : public Params::key_compare {
   IterType internal_find_multi(
       const key_type &key, IterType iter) const;
 
+  // Internal routine which implements find_unique_batch(). Looks up the next
+  // kFindBatch keys (or fewer, at the end) from b, advancing b past them, and
+  // returns how many results it stored in found.
+  template <typename IterType, typename ForwardIterator>
+  int internal_find_unique_batch(
+      ForwardIterator &b, ForwardIterator e,
+      IterType *found, IterType iter) const;
+
   // Deletes a node and all of its children.
   void internal_clear(node_type *node);
 
+  // Destroys the values of a node and all of its children without freeing
+  // the nodes.
+  void internal_destroy(node_type *node);
+
   // Dumps a node and all of its children to the specified ostream.
   void internal_dump(std::ostream &os, const node_type *node, int level) const;
 
@@ -1686,6 +1966,10 @@ void btree_iterator<N, R, P>::increment_slow() {
       node = node->child(0);
     }
     position = 0;
+    // Leaves are all at the same depth, so the next one is our sibling.
+    if (node->position() < node->parent()->count()) {
+      normal_node::prefetch(node->parent()->child(node->position() + 1));
+    }
   }
 }
 
@@ -1844,6 +2128,98 @@ void btree<P>::insert_multi(InputIterator b, InputIterator e) {
   }
 }
 
+template <typename P> template <typename ForwardIterator>
+void btree<P>::bulk_load(ForwardIterator b, ForwardIterator e, double fill) {
+  clear();
+  const size_type n = std::distance(b, e);
+  if (n == 0) {
+    return;
+  }
+
+  // Internal nodes need at least 2 values so that spreading the children
+  // evenly over a level never leaves a node with a single child.
+  const int leaf_values =
+      std::max(1, std::min(int(kNodeValues), int(fill * kNodeValues)));
+  const int internal_values = std::max(2, leaf_values);
+
+  // Every leaf but the first is preceded by a delimiting value that goes into
+  // an ancestor, so the leaves themselves hold n - leaves + 1 values.
+  size_type leaves = (n + leaf_values + 1) / (leaf_values + 1);
+  while (leaves > 1 && n - leaves + 1 < leaves) {
+    --leaves;
+  }
+  if (leaves == 1) {
+    node_type *leaf = new_leaf_root_node(n);
+    for (; b != e; ++b) {
+      leaf->insert_value(leaf->count(), *b);
+    }
+    *mutable_root() = leaf;
+    return;
+  }
+
+  // Build the leaf level, remembering where the delimiters are.
+  std::vector<node_type*> level;
+  std::vector<ForwardIterator> delimiters;
+  level.reserve(leaves);
+  delimiters.reserve(leaves - 1);
+  const size_type leaf_total = n - leaves + 1;
+  for (size_type i = 0; i < leaves; ++i) {
+    node_type *leaf = new_leaf_node(NULL);
+    const size_type count = leaf_total / leaves + (i < leaf_total % leaves);
+    for (size_type j = 0; j < count; ++j, ++b) {
+      leaf->insert_value(leaf->count(), *b);
+    }
+    level.push_back(leaf);
+    if (i + 1 < leaves) {
+      delimiters.push_back(b);
+      ++b;
+    }
+  }
+  node_type *leftmost = level.front();
+  node_type *rightmost = level.back();
+
+  // Group each level's nodes under parents until a single root remains. The
+  // delimiters between children of the same parent become its values, the
+  // ones between parents move up to the next level.
+  while (level.size() > 1) {
+    const size_type children = level.size();
+    const size_type per_parent = internal_values + 1;
+    const size_type parents = (children + per_parent - 1) / per_parent;
+    std::vector<node_type*> up;
+    std::vector<ForwardIterator> up_delimiters;
+    up.reserve(parents);
+    up_delimiters.reserve(parents - 1);
+    size_type c = 0;
+    for (size_type i = 0; i < parents; ++i) {
+      node_type *parent;
+      if (parents == 1) {
+        root_fields *f = reinterpret_cast<root_fields*>(
+            mutable_internal_allocator()->allocate(sizeof(root_fields)));
+        parent = node_type::init_root(f, leftmost);
+        *parent->mutable_rightmost() = rightmost;
+        *parent->mutable_size() = n;
+      } else {
+        parent = new_internal_node(NULL);
+      }
+      const size_type count =
+          children / parents + (i < children % parents);
+      parent->set_child(0, level[c]);
+      for (size_type j = 1; j < count; ++j, ++c) {
+        parent->insert_value(parent->count(), *delimiters[c]);
+        parent->set_child(parent->count(), level[c + 1]);
+      }
+      up.push_back(parent);
+      if (i + 1 < parents) {
+        up_delimiters.push_back(delimiters[c]);
+      }
+      ++c;
+    }
+    level.swap(up);
+    delimiters.swap(up_delimiters);
+  }
+  *mutable_root() = level.front();
+}
+
 template <typename P>
 void btree<P>::assign(const self_type &x) {
   clear();
@@ -1961,8 +2337,17 @@ int btree<P>::erase_multi(const key_type &key) {
 
 template <typename P>
 void btree<P>::clear() {
+  typedef btree_bulk_release<internal_allocator_type> bulk_release;
   if (root() != NULL) {
-    internal_clear(root());
+    if (bulk_release::owns_all(*mutable_internal_allocator())) {
+      if (!std::is_trivially_destructible<
+          typename node_type::mutable_value_type>::value) {
+        internal_destroy(root());
+      }
+      bulk_release::release(*mutable_internal_allocator());
+    } else {
+      internal_clear(root());
+    }
   }
   *mutable_root() = NULL;
 }
@@ -2247,6 +2632,7 @@ inline std::pair<IterType, int> btree<P>::internal_locate_plain_compare(
       break;
     }
     iter.node = iter.node->child(iter.position);
+    node_type::prefetch(iter.node);
   }
   return std::make_pair(iter, 0);
 }
@@ -2264,6 +2650,7 @@ inline std::pair<IterType, int> btree<P>::internal_locate_compare_to(
       break;
     }
     iter.node = iter.node->child(iter.position);
+    node_type::prefetch(iter.node);
   }
   return std::make_pair(iter, -kExactMatch);
 }
@@ -2279,6 +2666,7 @@ IterType btree<P>::internal_lower_bound(
         break;
       }
       iter.node = iter.node->child(iter.position);
+      node_type::prefetch(iter.node);
     }
     iter = internal_last(iter);
   }
@@ -2295,6 +2683,7 @@ IterType btree<P>::internal_upper_bound(
         break;
       }
       iter.node = iter.node->child(iter.position);
+      node_type::prefetch(iter.node);
     }
     iter = internal_last(iter);
   }
@@ -2319,6 +2708,55 @@ IterType btree<P>::internal_find_unique(
   return IterType(NULL, 0);
 }
 
+template <typename P> template <typename IterType, typename ForwardIterator>
+int btree<P>::internal_find_unique_batch(
+    ForwardIterator &b, ForwardIterator e,
+    IterType *found, IterType iter) const {
+  ForwardIterator keys[kFindBatch];
+  int n = 0;
+  for (; n < kFindBatch && b != e; ++n, ++b) {
+    keys[n] = b;
+    found[n] = iter;
+  }
+  if (!iter.node) {
+    return n;
+  }
+
+  // All leaves are at the same depth, so the lookups only part ways where a
+  // compare-to search finds its key in an internal node.
+  bool searching[kFindBatch];
+  std::fill(searching, searching + n, true);
+  for (int left = n; left > 0; ) {
+    for (int i = 0; i < n; ++i) {
+      if (!searching[i]) {
+        continue;
+      }
+      const key_type &key = *keys[i];
+      int res = found[i].node->lower_bound(key, key_comp());
+      found[i].position = res & kMatchMask;
+      if (res & kExactMatch) {
+        searching[i] = false;
+        --left;
+      } else if (found[i].node->leaf()) {
+        // Only a plain compare search can end on a match at a leaf without
+        // flagging it.
+        IterType last = internal_last(found[i]);
+        if (is_key_compare_to::value ||
+            !last.node || compare_keys(key, last.key())) {
+          last = IterType(NULL, 0);
+        }
+        found[i] = last;
+        searching[i] = false;
+        --left;
+      } else {
+        found[i].node = found[i].node->child(found[i].position);
+        btree_prefetch::prefetch(found[i].node, sizeof(leaf_fields));
+      }
+    }
+  }
+  return n;
+}
+
 template <typename P> template <typename IterType>
 IterType btree<P>::internal_find_multi(
     const key_type &key, IterType iter) const {
@@ -2350,6 +2788,16 @@ void btree<P>::internal_clear(node_type *node) {
   }
 }
 
+template <typename P>
+void btree<P>::internal_destroy(node_type *node) {
+  if (!node->leaf()) {
+    for (int i = 0; i <= node->count(); ++i) {
+      internal_destroy(node->child(i));
+    }
+  }
+  node->destroy();
+}
+
 template <typename P>
 void btree<P>::internal_dump(
     std::ostream &os, const node_type *node, int level) const {
@@ -0,0 +1,198 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// A btree_arena carves btree nodes out of large chunks instead of asking the
+// heap for each one. Freed nodes go onto a free list per node size and are
+// handed out again before the chunk is touched, and the whole arena is
+// returned to the heap a chunk at a time. btree_arena_allocator<> plugs it
+// into any btree container as the allocator:
+//
+//   btree::btree_set<int, std::less<int>, btree::btree_arena_allocator<int> >
+//
+// Every default constructed allocator owns a new arena, so each container
+// gets its own. Copies of an allocator (and therefore copies of a container)
+// share the arena. While a container is the only user of its arena, clear()
+// and destruction drop all nodes at once in O(chunks) instead of walking the
+// tree and freeing every node.
+
+#ifndef UTIL_BTREE_BTREE_ARENA_H__
+#define UTIL_BTREE_BTREE_ARENA_H__
+
+#include <stddef.h>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "btree.h"
+
+namespace btree {
+
+class btree_arena {
+ public:
+  explicit btree_arena(size_t chunk_size = 64 * 1024)
+      : cur_(NULL),
+        end_(NULL),
+        chunk_size_(chunk_size),
+        reserved_(0) {
+  }
+  ~btree_arena() {
+    release();
+  }
+
+  void* allocate(size_t bytes) {
+    bytes = round_up(bytes);
+    free_list *list = find_list(bytes);
+    if (list && list->head) {
+      free_node *n = list->head;
+      list->head = n->next;
+      return n;
+    }
+    if (size_t(end_ - cur_) < bytes) {
+      size_t size = std::max(chunk_size_, bytes);
+      cur_ = static_cast<char*>(::operator new(size));
+      end_ = cur_ + size;
+      chunks_.push_back(cur_);
+      reserved_ += size;
+    }
+    void *p = cur_;
+    cur_ += bytes;
+    return p;
+  }
+
+  void deallocate(void *p, size_t bytes) {
+    bytes = round_up(bytes);
+    free_list *list = find_list(bytes);
+    if (!list) {
+      free_list l = { bytes, NULL };
+      free_lists_.push_back(l);
+      list = &free_lists_.back();
+    }
+    free_node *n = static_cast<free_node*>(p);
+    n->next = list->head;
+    list->head = n;
+  }
+
+  // Returns every chunk to the heap. Anything allocated from the arena is
+  // gone afterwards.
+  void release() {
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+      ::operator delete(chunks_[i]);
+    }
+    chunks_.clear();
+    free_lists_.clear();
+    cur_ = end_ = NULL;
+    reserved_ = 0;
+  }
+
+  // The number of chunks and the bytes they hold.
+  size_t chunks() const { return chunks_.size(); }
+  size_t bytes_reserved() const { return reserved_; }
+
+ private:
+  struct free_node {
+    free_node *next;
+  };
+  struct free_list {
+    size_t size;
+    free_node *head;
+  };
+
+  // Keeps every block aligned for any node and big enough for a free_node.
+  static size_t round_up(size_t bytes) {
+    const size_t align = alignof(max_align_t);
+    bytes = std::max(bytes, sizeof(free_node));
+    return (bytes + align - 1) / align * align;
+  }
+
+  // A btree only uses a handful of node sizes, so a linear scan is fine.
+  free_list* find_list(size_t bytes) {
+    for (size_t i = 0; i < free_lists_.size(); ++i) {
+      if (free_lists_[i].size == bytes) {
+        return &free_lists_[i];
+      }
+    }
+    return NULL;
+  }
+
+  std::vector<char*> chunks_;
+  std::vector<free_list> free_lists_;
+  char *cur_;
+  char *end_;
+  size_t chunk_size_;
+  size_t reserved_;
+
+ private:
+  btree_arena(const btree_arena&);
+  void operator=(const btree_arena&);
+};
+
+template <typename T>
+class btree_arena_allocator {
+ public:
+  typedef T value_type;
+
+  btree_arena_allocator()
+      : arena_(std::make_shared<btree_arena>()) {
+  }
+  template <typename U>
+  btree_arena_allocator(const btree_arena_allocator<U> &x)
+      : arena_(x.arena()) {
+  }
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+  }
+  void deallocate(T *p, size_t n) {
+    arena_->deallocate(p, n * sizeof(T));
+  }
+
+  const std::shared_ptr<btree_arena>& arena() const { return arena_; }
+
+ private:
+  std::shared_ptr<btree_arena> arena_;
+};
+
+template <typename T, typename U>
+inline bool operator==(const btree_arena_allocator<T> &x,
+                       const btree_arena_allocator<U> &y) {
+  return x.arena() == y.arena();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const btree_arena_allocator<T> &x,
+                       const btree_arena_allocator<U> &y) {
+  return !(x == y);
+}
+
+// Lets clear() drop the arena instead of freeing the nodes one at a time,
+// unless another container shares it.
+template <typename T>
+struct btree_bulk_release<btree_arena_allocator<T> > {
+  static bool owns_all(const btree_arena_allocator<T> &alloc) {
+    return alloc.arena().use_count() == 1;
+  }
+  static void release(btree_arena_allocator<T> &alloc) {
+    alloc.arena()->release();
+  }
+};
+
+} // namespace btree
+
+#endif  // UTIL_BTREE_BTREE_ARENA_H__
@@ -90,6 +90,12 @@ class btree_container {
   void clear() {
     tree_.clear();
   }
+  // Replaces the contents with the sorted values in [b, e). See
+  // btree::bulk_load().
+  template <class ForwardIterator>
+  void bulk_load(ForwardIterator b, ForwardIterator e, double fill = 1.0) {
+    tree_.bulk_load(b, e, fill);
+  }
   void swap(self_type &x) {
     tree_.swap(x.tree_);
   }
@@ -185,6 +191,18 @@ class btree_unique_container : public btree_container<Tree> {
   const_iterator find(const key_type &key) const {
     return this->tree_.find_unique(key);
   }
+  // Looks up every key in [b, e), writing an iterator to it or end() to out
+  // for each. See btree::find_unique_batch().
+  template <class ForwardIterator, class OutputIterator>
+  OutputIterator find_batch(
+      ForwardIterator b, ForwardIterator e, OutputIterator out) {
+    return this->tree_.find_unique_batch(b, e, out);
+  }
+  template <class ForwardIterator, class OutputIterator>
+  OutputIterator find_batch(
+      ForwardIterator b, ForwardIterator e, OutputIterator out) const {
+    return this->tree_.find_unique_batch(b, e, out);
+  }
   size_type count(const key_type &key) const {
     return this->tree_.count_unique(key);
   }
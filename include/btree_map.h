@@ -70,6 +70,18 @@ class btree_map : public btree_map_container<
             const allocator_type &alloc = allocator_type())
       : super_type(b, e, comp, alloc) {
   }
+
+  // Bulk load constructor for sorted input without duplicates, e.g.
+  // btree_map(btree::sorted_input, v.begin(), v.end()). See
+  // btree::bulk_load().
+  template <class ForwardIterator>
+  btree_map(sorted_input_t, ForwardIterator b, ForwardIterator e,
+            double fill = 1.0,
+            const key_compare &comp = key_compare(),
+            const allocator_type &alloc = allocator_type())
+      : super_type(comp, alloc) {
+    this->bulk_load(b, e, fill);
+  }
 };
 
 template <typename K, typename V, typename C, typename A, int N>
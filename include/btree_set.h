@@ -33,12 +33,19 @@ namespace btree {
 template <typename Key,
           typename Compare = std::less<Key>,
           typename Alloc = std::allocator<Key>,
-          int TargetNodeSize = 256>
+          int TargetNodeSize = 256,
+          typename SearchPolicy = btree_default_search,
+          typename PrefetchPolicy = btree_no_prefetch>
 class btree_set : public btree_unique_container<
-  btree<btree_set_params<Key, Compare, Alloc, TargetNodeSize> > > {
-
-  typedef btree_set<Key, Compare, Alloc, TargetNodeSize> self_type;
-  typedef btree_set_params<Key, Compare, Alloc, TargetNodeSize> params_type;
+  btree<btree_set_params<Key, Compare, Alloc, TargetNodeSize,
+                         SearchPolicy, PrefetchPolicy> > > {
+
+  typedef btree_set<
+    Key, Compare, Alloc, TargetNodeSize, SearchPolicy,
+    PrefetchPolicy> self_type;
+  typedef btree_set_params<
+    Key, Compare, Alloc, TargetNodeSize, SearchPolicy,
+    PrefetchPolicy> params_type;
   typedef btree<params_type> btree_type;
   typedef btree_unique_container<btree_type> super_type;
 
@@ -65,10 +72,23 @@ class btree_set : public btree_unique_container<
             const allocator_type &alloc = allocator_type())
       : super_type(b, e, comp, alloc) {
   }
+
+  // Bulk load constructor for sorted input without duplicates, e.g.
+  // btree_set(btree::sorted_input, v.begin(), v.end()). See
+  // btree::bulk_load().
+  template <class ForwardIterator>
+  btree_set(sorted_input_t, ForwardIterator b, ForwardIterator e,
+            double fill = 1.0,
+            const key_compare &comp = key_compare(),
+            const allocator_type &alloc = allocator_type())
+      : super_type(comp, alloc) {
+    this->bulk_load(b, e, fill);
+  }
 };
 
-template <typename K, typename C, typename A, int N>
-inline void swap(btree_set<K, C, A, N> &x, btree_set<K, C, A, N> &y) {
+template <typename K, typename C, typename A, int N, typename S, typename F>
+inline void swap(btree_set<K, C, A, N, S, F> &x,
+                 btree_set<K, C, A, N, S, F> &y) {
   x.swap(y);
 }
 
@@ -76,12 +96,19 @@ inline void swap(btree_set<K, C, A, N> &x, btree_set<K, C, A, N> &y) {
 template <typename Key,
           typename Compare = std::less<Key>,
           typename Alloc = std::allocator<Key>,
-          int TargetNodeSize = 256>
+          int TargetNodeSize = 256,
+          typename SearchPolicy = btree_default_search,
+          typename PrefetchPolicy = btree_no_prefetch>
 class btree_multiset : public btree_multi_container<
-  btree<btree_set_params<Key, Compare, Alloc, TargetNodeSize> > > {
-
-  typedef btree_multiset<Key, Compare, Alloc, TargetNodeSize> self_type;
-  typedef btree_set_params<Key, Compare, Alloc, TargetNodeSize> params_type;
+  btree<btree_set_params<Key, Compare, Alloc, TargetNodeSize,
+                         SearchPolicy, PrefetchPolicy> > > {
+
+  typedef btree_multiset<
+    Key, Compare, Alloc, TargetNodeSize, SearchPolicy,
+    PrefetchPolicy> self_type;
+  typedef btree_set_params<
+    Key, Compare, Alloc, TargetNodeSize, SearchPolicy,
+    PrefetchPolicy> params_type;
   typedef btree<params_type> btree_type;
   typedef btree_multi_container<btree_type> super_type;
 
@@ -110,9 +137,9 @@ class btree_multiset : public btree_multi_container<
   }
 };
 
-template <typename K, typename C, typename A, int N>
-inline void swap(btree_multiset<K, C, A, N> &x,
-                 btree_multiset<K, C, A, N> &y) {
+template <typename K, typename C, typename A, int N, typename S, typename F>
+inline void swap(btree_multiset<K, C, A, N, S, F> &x,
+                 btree_multiset<K, C, A, N, S, F> &y) {
   x.swap(y);
 }
 
@@ -0,0 +1,166 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_CALIBRATION_HPP
+#define c6d28b7452ec699b_CALIBRATION_HPP
+
+#include <cycle.h>
+#include <stats.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <time.h>
+
+/*
+ * cycle.h deliberately returns ticks in arbitrary units: TSC cycles on x86,
+ * nanoseconds or timebase ticks elsewhere. This measures what a tick is on the
+ * running host, so results can be reported in ns and compared across hosts,
+ * and what getticks() itself costs, so that can be subtracted per region.
+ */
+namespace bench {
+
+// Wall clock in ns that is not slewed by NTP
+inline double monotonic_ns() {
+#if defined(CLOCK_MONOTONIC_RAW)
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	return double(ts.tv_sec) * 1e9 + double(ts.tv_nsec);
+#else
+	return double(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+struct Clock {
+	double ns_per_tick;
+	// Relative spread of ns_per_tick between calibration rounds
+	double drift;
+	// Median ticks of an empty getticks() pair, subtracted from each region
+	double overhead;
+	// Smallest non-zero difference between consecutive getticks()
+	double resolution;
+	// Whether the CPU flags were found at all (x86 Linux only)
+	bool tsc_checked;
+	// constant_tsc and nonstop_tsc: the TSC ticks at a fixed rate regardless
+	// of frequency scaling and keeps ticking in deep C-states
+	bool tsc_invariant;
+
+	Clock() : ns_per_tick(1.0), drift(0.0), overhead(0.0), resolution(1.0), tsc_checked(false), tsc_invariant(false) {
+	}
+
+	double to_ns(double t) const {
+		return t * ns_per_tick;
+	}
+
+	// Takes roughly rounds * round_ms milliseconds
+	static Clock calibrate(size_t rounds = 5, double round_ms = 20.0) {
+		Clock c;
+		c.check_tsc();
+
+		std::vector<double> rates;
+		for (size_t r = 0; r < rounds; ++r) {
+			ticks t0 = getticks();
+			double ns0 = sample(t0);
+			double ns1 = ns0;
+			ticks t1 = t0;
+			while (ns1 - ns0 < round_ms * 1e6) {
+				ns1 = sample(t1);
+			}
+			double dt = elapsed(t1, t0);
+			if (dt > 0.0) {
+				rates.push_back((ns1 - ns0) / dt);
+			}
+		}
+		if (!rates.empty()) {
+			c.ns_per_tick = median(rates);
+			std::vector<double>::const_iterator lo = std::min_element(rates.begin(), rates.end());
+			std::vector<double>::const_iterator hi = std::max_element(rates.begin(), rates.end());
+			c.drift = (*hi - *lo) / c.ns_per_tick;
+		}
+
+		std::vector<double> pairs;
+		pairs.reserve(1000);
+		double res = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < 1000; ++i) {
+			ticks a = getticks();
+			ticks b = getticks();
+			double d = elapsed(b, a);
+			pairs.push_back(d);
+			if (d > 0.0 && d < res) {
+				res = d;
+			}
+		}
+		c.overhead = median(pairs);
+		if (res != std::numeric_limits<double>::max()) {
+			c.resolution = res;
+		}
+		return c;
+	}
+
+private:
+	// Reads the wall clock between two getticks(), keeping the tightest of a
+	// few tries in case something got scheduled in between
+	static double sample(ticks& at) {
+		double best = std::numeric_limits<double>::max();
+		double ns = 0.0;
+		for (int i = 0; i < 5; ++i) {
+			ticks a = getticks();
+			double n = monotonic_ns();
+			ticks b = getticks();
+			double w = elapsed(b, a);
+			if (w < best) {
+				best = w;
+				ns = n;
+				at = a;
+			}
+		}
+		return ns;
+	}
+
+	void check_tsc() {
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+		std::ifstream cpuinfo("/proc/cpuinfo");
+		std::string line;
+		while (std::getline(cpuinfo, line)) {
+			if (line.compare(0, 5, "flags") != 0) {
+				continue;
+			}
+			std::istringstream flags(line.substr(line.find(':') + 1));
+			bool constant = false, nonstop = false;
+			std::string flag;
+			while (flags >> flag) {
+				constant = constant || (flag == "constant_tsc");
+				nonstop = nonstop || (flag == "nonstop_tsc");
+			}
+			tsc_checked = true;
+			tsc_invariant = constant && nonstop;
+			break;
+		}
+#endif
+	}
+};
+
+}
+
+#endif
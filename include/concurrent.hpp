@@ -0,0 +1,196 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_CONCURRENT_HPP
+#define c6d28b7452ec699b_CONCURRENT_HPP
+
+#include <bench.hpp>
+#include <stats.hpp>
+#include <workloads.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Sharing containers between threads: adaptors that put single-threaded
+ * containers behind locks, and a way to start threads at once inside a
+ * timed phase. Containers shared this way offer insert(), erase() and
+ * contains(), each returning a bool.
+ */
+namespace bench {
+
+template<typename Mutex>
+struct ReadLock {
+	typedef std::lock_guard<Mutex> type;
+};
+
+template<>
+struct ReadLock<std::shared_mutex> {
+	typedef std::shared_lock<std::shared_mutex> type;
+};
+
+// A container behind one lock, the usual way to share a single-threaded one;
+// lookups only take the lock shared if Mutex allows it
+template<typename Cont, typename Mutex = std::mutex>
+class locked_set {
+public:
+	typedef typename Cont::value_type value_type;
+
+	bool insert(const value_type& v) {
+		std::lock_guard<Mutex> lock(mutex);
+		return set.insert(v).second;
+	}
+
+	bool erase(const value_type& v) {
+		std::lock_guard<Mutex> lock(mutex);
+		return set.erase(v) != 0;
+	}
+
+	bool contains(const value_type& v) const {
+		typename ReadLock<Mutex>::type lock(mutex);
+		return set.find(v) != set.end();
+	}
+
+private:
+	mutable Mutex mutex;
+	Cont set;
+};
+
+// Keys hashed over Stripes containers, each behind its own lock, so threads
+// only contend when they touch the same stripe
+template<typename Cont, size_t Stripes = 64, typename Mutex = std::mutex>
+class striped_set {
+public:
+	typedef typename Cont::value_type value_type;
+
+	bool insert(const value_type& v) {
+		Stripe& s = stripe(v);
+		std::lock_guard<Mutex> lock(s.mutex);
+		return s.set.insert(v).second;
+	}
+
+	bool erase(const value_type& v) {
+		Stripe& s = stripe(v);
+		std::lock_guard<Mutex> lock(s.mutex);
+		return s.set.erase(v) != 0;
+	}
+
+	bool contains(const value_type& v) const {
+		const Stripe& s = stripe(v);
+		typename ReadLock<Mutex>::type lock(s.mutex);
+		return s.set.find(v) != s.set.end();
+	}
+
+private:
+	// A cache line each, so locking one stripe doesn't slow its neighbours
+	struct alignas(64) Stripe {
+		mutable Mutex mutex;
+		Cont set;
+	};
+
+	// Mixed, since std::hash of integers is the identity and the stripe
+	// containers hash the same bits again
+	static size_t index(const value_type& v) {
+		uint64_t h = uint64_t(std::hash<value_type>()(v)) * 0x9E3779B97F4A7C15ull;
+		return size_t(h >> 32) % Stripes;
+	}
+
+	Stripe& stripe(const value_type& v) {
+		return stripes[index(v)];
+	}
+
+	const Stripe& stripe(const value_type& v) const {
+		return stripes[index(v)];
+	}
+
+	std::array<Stripe, Stripes> stripes;
+};
+
+// Runs fn(i) for i in [0,count) on count threads. They are all started and
+// waiting before any begins, and the phase is timed from letting them go
+// until the last one is done, so thread creation stays out of it. Perf
+// counters would only see this thread waiting, so the phase reports none.
+template<typename F>
+void run_threads(size_t count, F fn, Timer *t = 0, size_t phase = 0) {
+	std::atomic<size_t> ready(0);
+	std::atomic<bool> go(false);
+	std::vector<std::thread> workers;
+	workers.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		workers.emplace_back([&, i] {
+			++ready;
+			while (!go.load(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+			fn(i);
+		});
+	}
+	while (ready.load() < count) {
+		std::this_thread::yield();
+	}
+	if (t) {
+		t->threaded();
+		t->start();
+	}
+	go.store(true, std::memory_order_release);
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].join();
+	}
+	if (t) {
+		t->stop(phase);
+	}
+}
+
+// Replays an operation trace against a shared container, with Latency adding
+// every operation's ticks, less overhead, to hist[op type]
+template<bool Latency, typename Cont, typename VT>
+size_t replay_shared(Cont& set, const VT& values, const std::vector<Op>& trace, Histogram *hist = 0, double overhead = 0.0) {
+	size_t res = 0;
+	ticks begin = ticks();
+	for (size_t i = 0; i < trace.size(); ++i) {
+		const Op& op = trace[i];
+		if (Latency) {
+			begin = getticks();
+		}
+		if (op.type == OP_LOOKUP) {
+			res += set.contains(values[op.key]);
+		}
+		else if (op.type == OP_INSERT) {
+			res += set.insert(values[op.key]);
+		}
+		else {
+			res += set.erase(values[op.key]);
+		}
+		if (Latency) {
+			hist[op.type].add(elapsed(getticks(), begin) - overhead);
+		}
+	}
+	return res;
+}
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_COUNTING_ALLOCATOR_HPP
+#define c6d28b7452ec699b_COUNTING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+
+/*
+ * An allocator that tracks how much memory the containers using it hold.
+ * All instances and rebinds share one set of counters, so wrap a single
+ * container at a time between alloc_stats().reset() and reading the stats.
+ */
+namespace bench {
+
+struct AllocStats {
+	// Bytes currently allocated
+	size_t live;
+	// Highest live seen since reset()
+	size_t peak;
+	size_t allocations;
+	size_t deallocations;
+
+	AllocStats() {
+		reset();
+	}
+
+	void reset() {
+		live = peak = allocations = deallocations = 0;
+	}
+};
+
+inline AllocStats& alloc_stats() {
+	static AllocStats stats;
+	return stats;
+}
+
+template<typename T>
+class counting_allocator {
+public:
+	typedef T value_type;
+
+	counting_allocator() {
+	}
+
+	template<typename U>
+	counting_allocator(const counting_allocator<U>&) {
+	}
+
+	T *allocate(size_t n) {
+		T *p = std::allocator<T>().allocate(n);
+		AllocStats& s = alloc_stats();
+		s.live += n * sizeof(T);
+		if (s.live > s.peak) {
+			s.peak = s.live;
+		}
+		++s.allocations;
+		return p;
+	}
+
+	void deallocate(T *p, size_t n) {
+		AllocStats& s = alloc_stats();
+		s.live -= n * sizeof(T);
+		++s.deallocations;
+		std::allocator<T>().deallocate(p, n);
+	}
+};
+
+template<typename T, typename U>
+inline bool operator==(const counting_allocator<T>&, const counting_allocator<U>&) {
+	return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const counting_allocator<T>&, const counting_allocator<U>&) {
+	return false;
+}
+
+}
+
+#endif
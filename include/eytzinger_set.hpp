@@ -0,0 +1,337 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_EYTZINGER_SET_HPP
+#define c6d28b7452ec699b_EYTZINGER_SET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <xmmintrin.h>
+#endif
+
+/*
+ * A read-only sorted set built once from sorted input, holding the keys in
+ * the breadth-first order of a complete binary search tree (Eytzinger
+ * layout): the root at index 1, and the children of index k at 2k and 2k+1.
+ *
+ * Binary search over a sorted array jumps across the array on every step, so
+ * each of the first steps is a cache miss, and which way it goes is a coin
+ * flip the branch predictor can't learn. Here the first levels of the tree
+ * share a few cache lines that stay hot, the search computes the next index
+ * from the comparison instead of branching on it, and because all 16
+ * descendants 4 levels down of a 4 byte key sit in one cache line, that line
+ * is prefetched while the 4 levels in between are searched.
+ *
+ * Iterating walks the tree in order, so it visits the keys sorted, but it is
+ * slower than walking a sorted array.
+ */
+namespace bench {
+
+namespace eytzinger_detail {
+
+// The number of 1 bits below the lowest 0 bit
+inline size_t trailing_ones(size_t k) {
+	const uint64_t z = ~uint64_t(k);
+#if defined(__GNUC__)
+	return size_t(__builtin_ctzll(z));
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i;
+	_BitScanForward64(&i, z);
+	return size_t(i);
+#else
+	size_t i = 0;
+	while (k & 1) {
+		k >>= 1;
+		++i;
+	}
+	return i;
+#endif
+}
+
+inline void prefetch(const void *p) {
+#if defined(__GNUC__)
+	__builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+	(void)p;
+#endif
+}
+
+// Storage aligned to a cache line, so that the blocks of keys the searches
+// count on sharing a line do
+template<typename T>
+T *allocate_lines(size_t n) {
+	return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(64)));
+}
+
+template<typename T>
+void deallocate_lines(T *p) {
+	::operator delete(p, std::align_val_t(64));
+}
+
+}
+
+template<typename T, typename Compare = std::less<T> >
+class eytzinger_set {
+public:
+	typedef T value_type;
+	typedef T key_type;
+	typedef size_t size_type;
+	typedef Compare key_compare;
+
+	class const_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const T *pointer;
+		typedef const T& reference;
+
+		const_iterator() : data(0), k(0), n(0) {
+		}
+
+		reference operator*() const {
+			return data[k];
+		}
+
+		pointer operator->() const {
+			return data + k;
+		}
+
+		// On to the leftmost key of the right subtree if there is one, else
+		// up past every ancestor this is in the right subtree of; past the
+		// root that is index 0, the end
+		const_iterator& operator++() {
+			if (2 * k + 1 <= n) {
+				k = 2 * k + 1;
+				while (2 * k <= n) {
+					k = 2 * k;
+				}
+			}
+			else {
+				k >>= eytzinger_detail::trailing_ones(k) + 1;
+			}
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			const_iterator rv = *this;
+			++*this;
+			return rv;
+		}
+
+		bool operator==(const const_iterator& o) const {
+			return k == o.k;
+		}
+
+		bool operator!=(const const_iterator& o) const {
+			return k != o.k;
+		}
+
+	private:
+		friend class eytzinger_set;
+
+		const_iterator(const T *data, size_t k, size_t n) : data(data), k(k), n(n) {
+		}
+
+		const T *data;
+		size_t k;
+		size_t n;
+	};
+	typedef const_iterator iterator;
+
+	explicit eytzinger_set(const Compare& comp = Compare()) : data(0), elements(0), comp(comp) {
+	}
+
+	// [first, last) must be sorted and without duplicates
+	template<typename ForwardIterator>
+	eytzinger_set(ForwardIterator first, ForwardIterator last, const Compare& comp = Compare()) : data(0), elements(0), comp(comp) {
+		assign(first, last);
+	}
+
+	eytzinger_set(const eytzinger_set& o) : data(0), elements(0), comp(o.comp) {
+		data = eytzinger_detail::allocate_lines<T>(o.elements + 1);
+		for (; elements < o.elements; ++elements) {
+			new (data + elements + 1) T(o.data[elements + 1]);
+		}
+	}
+
+	eytzinger_set(eytzinger_set&& o) noexcept : data(o.data), elements(o.elements), comp(o.comp) {
+		o.data = 0;
+		o.elements = 0;
+	}
+
+	eytzinger_set& operator=(eytzinger_set o) {
+		swap(o);
+		return *this;
+	}
+
+	~eytzinger_set() {
+		release();
+	}
+
+	void swap(eytzinger_set& o) {
+		std::swap(data, o.data);
+		std::swap(elements, o.elements);
+		std::swap(comp, o.comp);
+	}
+
+	// Replaces the contents with [first, last), which must be sorted and
+	// without duplicates
+	template<typename ForwardIterator>
+	void assign(ForwardIterator first, ForwardIterator last) {
+		const Compare& c = comp;
+		if (std::adjacent_find(first, last, [&c](const T& a, const T& b) { return !c(a, b); }) != last) {
+			throw std::invalid_argument("eytzinger_set: input must be sorted and without duplicates");
+		}
+		release();
+		const size_t n = size_t(std::distance(first, last));
+		data = eytzinger_detail::allocate_lines<T>(n + 1);
+		size_t built = 0;
+		try {
+			fill(first, 1, n, built);
+		}
+		catch (...) {
+			// The keys placed so far are the first ones in order
+			for (const_iterator it(data, leftmost(n), n); built; --built, ++it) {
+				data[it.k].~T();
+			}
+			eytzinger_detail::deallocate_lines(data);
+			data = 0;
+			throw;
+		}
+		elements = n;
+	}
+
+	size_type size() const {
+		return elements;
+	}
+
+	bool empty() const {
+		return elements == 0;
+	}
+
+	void clear() {
+		release();
+	}
+
+	const_iterator begin() const {
+		return const_iterator(data, leftmost(elements), elements);
+	}
+
+	const_iterator end() const {
+		return const_iterator(data, 0, elements);
+	}
+
+	// Each step goes left or right by adding the comparison to 2k, and once
+	// k is past the leaves its bits spell out the path taken. The lower bound
+	// is where the path last went left, found by dropping the trailing right
+	// turns and the left turn before them; if it never went left, k ends up
+	// 0, the end.
+	const_iterator lower_bound(const T& v) const {
+		const size_t n = elements;
+		size_t k = 1;
+		while (k <= n) {
+			eytzinger_detail::prefetch(data + k * PREFETCH_STRIDE);
+			k = 2 * k + size_t(comp(data[k], v));
+		}
+		k >>= eytzinger_detail::trailing_ones(k) + 1;
+		return const_iterator(data, k, n);
+	}
+
+	const_iterator find(const T& v) const {
+		const_iterator it = lower_bound(v);
+		if (it.k && comp(v, data[it.k])) {
+			return end();
+		}
+		return it;
+	}
+
+	size_type count(const T& v) const {
+		return find(v) != end();
+	}
+
+	bool contains(const T& v) const {
+		return find(v) != end();
+	}
+
+	key_compare key_comp() const {
+		return comp;
+	}
+
+private:
+	// The S descendants log2(S) levels down of k are the S keys from S*k,
+	// which fill one cache line when S is the keys per line
+	static const size_t PREFETCH_STRIDE = (64 / sizeof(T)) ? (64 / sizeof(T)) : 1;
+
+	// The first key in order of a tree of n keys, or 0 if there are none
+	static size_t leftmost(size_t n) {
+		size_t k = n ? 1 : 0;
+		while (k && 2 * k <= n) {
+			k = 2 * k;
+		}
+		return k;
+	}
+
+	// Places the keys in order into the subtree at k by an in-order walk
+	template<typename ForwardIterator>
+	void fill(ForwardIterator& it, size_t k, size_t n, size_t& built) {
+		if (k > n) {
+			return;
+		}
+		fill(it, 2 * k, n, built);
+		new (data + k) T(*it);
+		++built;
+		++it;
+		fill(it, 2 * k + 1, n, built);
+	}
+
+	void release() {
+		if (!data) {
+			return;
+		}
+		for (size_t k = 1; k <= elements; ++k) {
+			data[k].~T();
+		}
+		eytzinger_detail::deallocate_lines(data);
+		data = 0;
+		elements = 0;
+	}
+
+	T *data;
+	size_t elements;
+	Compare comp;
+};
+
+}
+
+#endif
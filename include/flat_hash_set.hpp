@@ -0,0 +1,490 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_FLAT_HASH_SET_HPP
+#define c6d28b7452ec699b_FLAT_HASH_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define FLAT_HASH_SET_SSE2 1
+	#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+/*
+ * An open addressing hash set in the style of Swiss tables: the elements sit
+ * in one flat array, and a parallel array of control bytes holds 7 bits of
+ * each element's hash, or 0x80 for an empty slot. Lookups compare 16 control
+ * bytes at once with SSE2, and only touch elements whose 7 bits match.
+ *
+ * Unlike Swiss tables, which probe aligned groups quadratically and leave
+ * tombstones behind on erase, this probes linearly from the element's home
+ * slot, loading 16 control bytes at any offset. The first 15 control bytes
+ * are mirrored past the end so those loads wrap around. Linear probing lets
+ * erase() shift the following elements back instead of leaving a tombstone,
+ * so lookups never wade through deleted slots and the table never needs
+ * rehashing to clean up.
+ *
+ * Capacity is a power of 2, at least 16, and grows by doubling once the set
+ * would be more than 7/8 full. Inserting or erasing invalidates iterators.
+ */
+namespace bench {
+
+namespace flat_hash_detail {
+
+// A bitmask of which of 16 control bytes match
+struct Group {
+	enum { SIZE = 16 };
+	static const uint8_t EMPTY = 0x80;
+
+#ifdef FLAT_HASH_SET_SSE2
+	__m128i ctrl;
+
+	explicit Group(const uint8_t *p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {
+	}
+
+	uint32_t match(uint8_t h2) const {
+		return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(char(h2)))));
+	}
+
+	// Only empty slots have the high bit set
+	uint32_t empty() const {
+		return uint32_t(_mm_movemask_epi8(ctrl));
+	}
+#else
+	uint8_t ctrl[SIZE];
+
+	explicit Group(const uint8_t *p) {
+		std::memcpy(ctrl, p, SIZE);
+	}
+
+	uint32_t match(uint8_t h2) const {
+		uint32_t rv = 0;
+		for (uint32_t i = 0; i < SIZE; ++i) {
+			rv |= uint32_t(ctrl[i] == h2) << i;
+		}
+		return rv;
+	}
+
+	uint32_t empty() const {
+		uint32_t rv = 0;
+		for (uint32_t i = 0; i < SIZE; ++i) {
+			rv |= uint32_t(ctrl[i] >> 7) << i;
+		}
+		return rv;
+	}
+#endif
+};
+
+inline uint32_t lowest_bit(uint32_t mask) {
+#if defined(__GNUC__)
+	return uint32_t(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward(&i, mask);
+	return uint32_t(i);
+#else
+	uint32_t i = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		++i;
+	}
+	return i;
+#endif
+}
+
+// Spreads the hash over all bits, since std::hash of integers is the identity
+inline uint64_t mix(size_t h) {
+	uint64_t m = uint64_t(h) * 0x9E3779B97F4A7C15ull;
+	return m ^ (m >> 32);
+}
+
+}
+
+template<typename T, typename Hash = std::hash<T>, typename Eq = std::equal_to<T>, typename Alloc = std::allocator<T> >
+class flat_hash_set {
+	typedef flat_hash_detail::Group Group;
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<uint8_t> ctrl_allocator;
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<T> slot_allocator;
+
+public:
+	typedef T value_type;
+	typedef T key_type;
+	typedef size_t size_type;
+	typedef Hash hasher;
+	typedef Eq key_equal;
+	typedef Alloc allocator_type;
+
+	class const_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const T *pointer;
+		typedef const T& reference;
+
+		const_iterator() : ctrl(0), end(0), slot(0) {
+		}
+
+		reference operator*() const {
+			return *slot;
+		}
+
+		pointer operator->() const {
+			return slot;
+		}
+
+		const_iterator& operator++() {
+			++ctrl;
+			++slot;
+			skip();
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			const_iterator rv = *this;
+			++*this;
+			return rv;
+		}
+
+		bool operator==(const const_iterator& o) const {
+			return slot == o.slot;
+		}
+
+		bool operator!=(const const_iterator& o) const {
+			return slot != o.slot;
+		}
+
+	private:
+		friend class flat_hash_set;
+
+		const_iterator(const uint8_t *ctrl, const uint8_t *end, const T *slot) : ctrl(ctrl), end(end), slot(slot) {
+		}
+
+		void skip() {
+			while (ctrl != end && *ctrl == Group::EMPTY) {
+				++ctrl;
+				++slot;
+			}
+		}
+
+		const uint8_t *ctrl;
+		const uint8_t *end;
+		const T *slot;
+	};
+	typedef const_iterator iterator;
+
+	explicit flat_hash_set(const Alloc& alloc = Alloc()) : alloc(alloc), ctrl(0), slots(0), mask(0), elements(0) {
+	}
+
+	flat_hash_set(const flat_hash_set& o) : hash(o.hash), eq(o.eq), alloc(o.alloc), ctrl(0), slots(0), mask(0), elements(0) {
+		reserve(o.size());
+		for (const_iterator it = o.begin(); it != o.end(); ++it) {
+			insert(*it);
+		}
+	}
+
+	flat_hash_set(flat_hash_set&& o) : hash(o.hash), eq(o.eq), alloc(o.alloc), ctrl(o.ctrl), slots(o.slots), mask(o.mask), elements(o.elements) {
+		o.ctrl = 0;
+		o.slots = 0;
+		o.mask = 0;
+		o.elements = 0;
+	}
+
+	flat_hash_set& operator=(flat_hash_set o) {
+		swap(o);
+		return *this;
+	}
+
+	~flat_hash_set() {
+		release();
+	}
+
+	void swap(flat_hash_set& o) {
+		std::swap(hash, o.hash);
+		std::swap(eq, o.eq);
+		std::swap(alloc, o.alloc);
+		std::swap(ctrl, o.ctrl);
+		std::swap(slots, o.slots);
+		std::swap(mask, o.mask);
+		std::swap(elements, o.elements);
+	}
+
+	size_type size() const {
+		return elements;
+	}
+
+	bool empty() const {
+		return elements == 0;
+	}
+
+	size_type capacity() const {
+		return ctrl ? mask + 1 : 0;
+	}
+
+	double load_factor() const {
+		return ctrl ? double(elements) / double(capacity()) : 0.0;
+	}
+
+	const_iterator begin() const {
+		if (!ctrl) {
+			return end();
+		}
+		const_iterator it(ctrl, ctrl + capacity(), slots);
+		it.skip();
+		return it;
+	}
+
+	const_iterator end() const {
+		return const_iterator(ctrl + capacity(), ctrl + capacity(), slots + capacity());
+	}
+
+	const_iterator find(const T& v) const {
+		size_t pos;
+		if (!locate(v, flat_hash_detail::mix(hash(v)), pos)) {
+			return end();
+		}
+		return const_iterator(ctrl + pos, ctrl + capacity(), slots + pos);
+	}
+
+	size_type count(const T& v) const {
+		size_t pos;
+		return locate(v, flat_hash_detail::mix(hash(v)), pos);
+	}
+
+	bool contains(const T& v) const {
+		return count(v) != 0;
+	}
+
+	std::pair<const_iterator, bool> insert(const T& v) {
+		uint64_t h = flat_hash_detail::mix(hash(v));
+		size_t pos;
+		if (locate(v, h, pos)) {
+			return std::make_pair(const_iterator(ctrl + pos, ctrl + capacity(), slots + pos), false);
+		}
+		if (grow_for(elements + 1)) {
+			pos = free_slot(h);
+		}
+		new (slots + pos) T(v);
+		set_ctrl(pos, h2(h));
+		++elements;
+		return std::make_pair(const_iterator(ctrl + pos, ctrl + capacity(), slots + pos), true);
+	}
+
+	template<typename InputIterator>
+	void insert(InputIterator b, InputIterator e) {
+		for (; b != e; ++b) {
+			insert(*b);
+		}
+	}
+
+	size_type erase(const T& v) {
+		size_t pos;
+		if (!locate(v, flat_hash_detail::mix(hash(v)), pos)) {
+			return 0;
+		}
+		erase_slot(pos);
+		return 1;
+	}
+
+	void clear() {
+		for (size_t i = 0; i < capacity(); ++i) {
+			if (ctrl[i] != Group::EMPTY) {
+				slots[i].~T();
+			}
+		}
+		if (ctrl) {
+			std::memset(ctrl, Group::EMPTY, capacity() + Group::SIZE - 1);
+		}
+		elements = 0;
+	}
+
+	// Makes room for n elements without growing
+	void reserve(size_type n) {
+		grow_for(n);
+	}
+
+	hasher hash_function() const {
+		return hash;
+	}
+
+	key_equal key_eq() const {
+		return eq;
+	}
+
+	allocator_type get_allocator() const {
+		return alloc;
+	}
+
+private:
+	static uint8_t h2(uint64_t h) {
+		return uint8_t(h & 0x7F);
+	}
+
+	size_t home(uint64_t h) const {
+		return size_t(h >> 7) & mask;
+	}
+
+	void set_ctrl(size_t i, uint8_t c) {
+		ctrl[i] = c;
+		if (i < Group::SIZE - 1) {
+			ctrl[mask + 1 + i] = c;
+		}
+	}
+
+	// Finds v and sets pos to its slot, or else to the free slot it would be
+	// inserted into. Matches after the first empty slot are from other runs.
+	bool locate(const T& v, uint64_t h, size_t& pos) const {
+		if (!ctrl) {
+			pos = 0;
+			return false;
+		}
+		const uint8_t tag = h2(h);
+		for (size_t i = home(h);; i = (i + Group::SIZE) & mask) {
+			Group g(ctrl + i);
+			uint32_t match = g.match(tag);
+			uint32_t empty = g.empty();
+			if (empty) {
+				match &= (empty & (0u - empty)) - 1;
+			}
+			while (match) {
+				size_t j = (i + flat_hash_detail::lowest_bit(match)) & mask;
+				if (eq(slots[j], v)) {
+					pos = j;
+					return true;
+				}
+				match &= match - 1;
+			}
+			if (empty) {
+				pos = (i + flat_hash_detail::lowest_bit(empty)) & mask;
+				return false;
+			}
+		}
+	}
+
+	// The first empty slot from h's home
+	size_t free_slot(uint64_t h) const {
+		for (size_t i = home(h);; i = (i + Group::SIZE) & mask) {
+			uint32_t empty = Group(ctrl + i).empty();
+			if (empty) {
+				return (i + flat_hash_detail::lowest_bit(empty)) & mask;
+			}
+		}
+	}
+
+	// Shifts the rest of the run back over the erased slot, so that no
+	// element is separated from its home by an empty slot
+	void erase_slot(size_t i) {
+		slots[i].~T();
+		for (size_t k = (i + 1) & mask; ctrl[k] != Group::EMPTY; k = (k + 1) & mask) {
+			size_t h = home(flat_hash_detail::mix(hash(slots[k])));
+			// Only if k's home is not between the hole and k
+			if (((k - h) & mask) >= ((k - i) & mask)) {
+				new (slots + i) T(std::move(slots[k]));
+				slots[k].~T();
+				set_ctrl(i, ctrl[k]);
+				i = k;
+			}
+		}
+		set_ctrl(i, Group::EMPTY);
+		--elements;
+	}
+
+	// Doubles the capacity until n elements fit at most 7/8 full, and
+	// returns whether it had to
+	bool grow_for(size_type n) {
+		size_t cap = capacity();
+		if (n <= cap - cap / 8) {
+			return false;
+		}
+		if (cap == 0) {
+			cap = Group::SIZE;
+		}
+		while (n > cap - cap / 8) {
+			cap *= 2;
+		}
+		rehash(cap);
+		return true;
+	}
+
+	void rehash(size_t cap) {
+		uint8_t *old_ctrl = ctrl;
+		T *old_slots = slots;
+		size_t old_cap = capacity();
+
+		ctrl_allocator ca(alloc);
+		slot_allocator sa(alloc);
+		ctrl = ca.allocate(cap + Group::SIZE - 1);
+		slots = sa.allocate(cap);
+		std::memset(ctrl, Group::EMPTY, cap + Group::SIZE - 1);
+		mask = cap - 1;
+
+		for (size_t i = 0; i < old_cap; ++i) {
+			if (old_ctrl[i] == Group::EMPTY) {
+				continue;
+			}
+			uint64_t h = flat_hash_detail::mix(hash(old_slots[i]));
+			size_t pos = free_slot(h);
+			new (slots + pos) T(std::move(old_slots[i]));
+			old_slots[i].~T();
+			set_ctrl(pos, h2(h));
+		}
+		if (old_ctrl) {
+			ca.deallocate(old_ctrl, old_cap + Group::SIZE - 1);
+			sa.deallocate(old_slots, old_cap);
+		}
+	}
+
+	void release() {
+		if (!ctrl) {
+			return;
+		}
+		clear();
+		ctrl_allocator ca(alloc);
+		slot_allocator sa(alloc);
+		ca.deallocate(ctrl, capacity() + Group::SIZE - 1);
+		sa.deallocate(slots, capacity());
+		ctrl = 0;
+		slots = 0;
+		mask = 0;
+	}
+
+	Hash hash;
+	Eq eq;
+	Alloc alloc;
+	uint8_t *ctrl;
+	T *slots;
+	size_t mask;
+	size_t elements;
+};
+
+}
+
+#endif
@@ -56,28 +56,33 @@ inline double PrintStats(std::vector<double> timings) {
 
     std::cout << std::fixed << std::setprecision(2);
     std::cout << "[";
-    for (size_t i = 0 ; i<timings.size()-1 ; ++i) {
+    for (size_t i = 0 ; i<timings.size() ; ++i) {
         fastest = std::min(fastest, timings[i]);
-        std::cout << timings[i] << ",";
+        if (i) {
+            std::cout << ",";
+        }
+        std::cout << timings[i];
     }
-    std::cout << timings.back();
     std::cout << "]";
 
     double sum = 0.0;
     for (size_t i = 0 ; i<timings.size() ; ++i) {
         sum += timings[i];
     }
-    double avg = sum / double(timings.size()-1);
+    double avg = sum / double(timings.size());
+
+    std::sort(timings.begin(), timings.end());
+    size_t mid = timings.size()/2;
+    double median = (timings.size() & 1) ? timings[mid] : (timings[mid-1] + timings[mid]) / 2.0;
 
     sum = 0.0;
     for (size_t i = 0 ; i<timings.size() ; ++i) {
-        timings[i] = pow(timings[i]-avg, 2);
-        sum += timings[i];
+        sum += pow(timings[i]-avg, 2);
     }
-    double var = sum/(timings.size()-2);
+    double var = timings.size() > 1 ? sum/(timings.size()-1) : 0.0;
     double sdv = sqrt(var);
 
-    std::cout << " with fastest " << fastest << ", average " << avg << ", stddev " << sdv;
+    std::cout << " with fastest " << fastest << ", median " << median << ", average " << avg << ", stddev " << sdv;
     return fastest;
 }
 
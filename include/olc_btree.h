@@ -0,0 +1,586 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// A B+tree that any number of threads can read and write at once, using
+// optimistic lock coupling (Leis et al., "The ART of Practical
+// Synchronization", DaMoN 2016). Every node carries a version counter that
+// doubles as a write latch:
+//
+//   - Readers never write to shared memory. They note the version of each
+//     node on the way down and check it again after reading from the node,
+//     starting over from the root if a writer got in between.
+//
+//   - Writers descend the same way and latch only the nodes they change: the
+//     leaf they insert into or erase from, and for a split the node and its
+//     parent. Full internal nodes are split on the way down, so a split never
+//     has to propagate upwards.
+//
+// Nodes are sized by TargetNodeSize and hold sorted key arrays like the nodes
+// of btree.h, but values live only in the leaves. A reader may copy keys and
+// values that a writer is changing before the version check throws them
+// away, so both must be trivially copyable. For the same reason nodes are
+// never freed while the tree exists: erase() leaves underfull and even empty
+// leaves in place instead of merging them, which keeps every pointer a reader
+// can pick up valid.
+//
+// There are no iterators. size() and verify() walk the tree and must not run
+// concurrently with writers.
+
+#ifndef UTIL_BTREE_OLC_BTREE_H__
+#define UTIL_BTREE_OLC_BTREE_H__
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+namespace btree {
+
+// Tells other hyperthreads that this one is spinning.
+inline void olc_pause() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+// A version counter and write latch in one word. Bit 1 is set while a writer
+// holds the latch; taking and releasing it both add 2, so every write moves
+// the version on.
+class olc_latch {
+ public:
+  olc_latch()
+      : version_(0) {
+  }
+
+  // Returns the version to validate reads against, or sets *restart if a
+  // writer holds the latch.
+  uint64_t read_lock(bool *restart) const {
+    uint64_t v = version_.load(std::memory_order_acquire);
+    if (v & kLocked) {
+      olc_pause();
+      *restart = true;
+    }
+    return v;
+  }
+
+  // Sets *restart if the node has changed since read_lock() returned v.
+  // Whatever was read from the node in between is only good if it did not.
+  void validate(uint64_t v, bool *restart) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (version_.load(std::memory_order_relaxed) != v) {
+      *restart = true;
+    }
+  }
+
+  // Takes the latch if the node is still at version *v, or sets *restart.
+  void upgrade(uint64_t *v, bool *restart) {
+    if (version_.compare_exchange_strong(*v, *v + kLocked)) {
+      *v += kLocked;
+    } else {
+      olc_pause();
+      *restart = true;
+    }
+  }
+
+  void unlock() {
+    version_.fetch_add(kLocked, std::memory_order_release);
+  }
+
+ private:
+  enum { kLocked = 2 };
+
+  std::atomic<uint64_t> version_;
+};
+
+// The values a leaf holds besides its keys; nothing for sets.
+template <typename Data, int N>
+struct olc_leaf_data {
+  enum { kSize = sizeof(Data) };
+
+  void move(int dst, const olc_leaf_data &src, int i, int n) {
+    memmove(values + dst, src.values + i, n * sizeof(Data));
+  }
+
+  Data values[N];
+};
+
+template <int N>
+struct olc_leaf_data<void, N> {
+  enum { kSize = 0 };
+
+  void move(int, const olc_leaf_data&, int, int) {}
+};
+
+template <typename Key, typename Data, typename Compare, int TargetNodeSize>
+class olc_btree {
+ public:
+  typedef Key key_type;
+  typedef Data data_type;
+  typedef Compare key_compare;
+  typedef size_t size_type;
+
+ private:
+  struct node_type {
+    explicit node_type(bool is_leaf)
+        : count(0),
+          leaf(is_leaf) {
+    }
+
+    olc_latch latch;
+    // Read without the latch, so kept atomic to never be torn.
+    std::atomic<int> count;
+    const bool leaf;
+  };
+
+  enum {
+    kNodeBytes = TargetNodeSize > int(sizeof(node_type))
+        ? TargetNodeSize - int(sizeof(node_type)) : 0,
+    kLeafSlots = kNodeBytes /
+        int(sizeof(Key) + olc_leaf_data<Data, 1>::kSize),
+    kInternalSlots = (kNodeBytes - int(sizeof(void*))) /
+        int(sizeof(Key) + sizeof(void*)),
+    // Splitting needs at least 3 values per node.
+    kLeafValues = kLeafSlots > 3 ? kLeafSlots : 3,
+    kInternalValues = kInternalSlots > 3 ? kInternalSlots : 3,
+  };
+
+  struct leaf_type : public node_type {
+    leaf_type()
+        : node_type(true) {
+    }
+
+    key_type keys[kLeafValues];
+    olc_leaf_data<Data, kLeafValues> data;
+  };
+
+  struct internal_type : public node_type {
+    internal_type()
+        : node_type(false) {
+    }
+
+    // children[i] holds the keys up to and including keys[i].
+    key_type keys[kInternalValues];
+    node_type *children[kInternalValues + 1];
+  };
+
+ public:
+  typedef olc_leaf_data<Data, kLeafValues> leaf_data;
+
+  explicit olc_btree(const key_compare &comp = key_compare())
+      : comp_(comp),
+        root_(new leaf_type) {
+    static_assert(std::is_trivially_copyable<Key>::value,
+                  "readers copy keys while writers change them");
+    static_assert(std::is_trivially_copyable<
+                    typename std::conditional<std::is_void<Data>::value,
+                                              int, Data>::type>::value,
+                  "readers copy values while writers change them");
+  }
+  ~olc_btree() {
+    internal_clear(root_.load(std::memory_order_relaxed));
+  }
+
+  // Inserts k unless it is present, calling store(data, i) with the latch
+  // held to fill in the value at slot i of the leaf. Returns whether k was
+  // inserted.
+  template <typename Store>
+  bool insert_unique(const key_type &k, Store store);
+
+  // Calls load(data, i) to copy out the value for k and returns true, or
+  // returns false if k is not present. load() may see a value a writer is
+  // changing, but then it is called again once the tree has settled.
+  template <typename Load>
+  bool find_unique(const key_type &k, Load load) const;
+
+  bool contains(const key_type &k) const {
+    return find_unique(k, [](const leaf_data&, int) {});
+  }
+
+  // Erases k and returns whether it was present.
+  bool erase_unique(const key_type &k);
+
+  // The number of keys. Not safe against concurrent writers.
+  size_type size() const {
+    return internal_size(root_.load(std::memory_order_relaxed));
+  }
+  bool empty() const { return size() == 0; }
+
+  // Checks the ordering of the whole tree. Not safe against concurrent
+  // writers.
+  void verify() const {
+    internal_verify(root_.load(std::memory_order_relaxed), NULL, NULL);
+  }
+
+  const key_compare& key_comp() const { return comp_; }
+
+  static size_type leaf_values() { return kLeafValues; }
+  static size_type internal_values() { return kInternalValues; }
+
+ private:
+  static leaf_type* as_leaf(node_type *n) {
+    return static_cast<leaf_type*>(n);
+  }
+  static internal_type* as_internal(node_type *n) {
+    return static_cast<internal_type*>(n);
+  }
+
+  // The index of the first of the n keys that is not less than k. Like
+  // btree.h, integral and floating point keys are scanned linearly.
+  int lower_bound(const key_type *keys, int n, const key_type &k) const {
+    if (std::is_integral<key_type>::value ||
+        std::is_floating_point<key_type>::value) {
+      int i = 0;
+      while (i < n && comp_(keys[i], k)) {
+        ++i;
+      }
+      return i;
+    }
+    return int(std::lower_bound(keys, keys + n, k, comp_) - keys);
+  }
+
+  // Descends from the root to the leaf for k, or with stop_at_full to the
+  // first full internal node on the way. Returns the node, its version and
+  // the parent it was reached through, or NULL if a writer got in the way.
+  node_type* descend(const key_type &k, bool stop_at_full, uint64_t *version,
+                     internal_type **parent,
+                     uint64_t *parent_version) const;
+
+  // Splits node, which is full and was at version when read, adding the new
+  // sibling to parent or to a new root. Both are latched while it happens.
+  // The caller starts over whether or not the split went through.
+  void split(internal_type *parent, uint64_t parent_version,
+             node_type *node, uint64_t version);
+
+  void internal_clear(node_type *node);
+  size_type internal_size(const node_type *node) const;
+  void internal_verify(const node_type *node,
+                       const key_type *lo, const key_type *hi) const;
+
+ private:
+  key_compare comp_;
+  std::atomic<node_type*> root_;
+
+ private:
+  olc_btree(const olc_btree&);
+  void operator=(const olc_btree&);
+};
+
+////
+// olc_btree methods
+template <typename K, typename D, typename C, int N>
+template <typename Store>
+bool olc_btree<K, D, C, N>::insert_unique(const key_type &k, Store store) {
+  for (;;) {
+    bool restart = false;
+    uint64_t version, parent_version;
+    internal_type *parent;
+    node_type *node = descend(k, true, &version, &parent, &parent_version);
+    if (!node) {
+      continue;
+    }
+    if (!node->leaf) {
+      split(parent, parent_version, node, version);
+      continue;
+    }
+
+    leaf_type *leaf = as_leaf(node);
+    int n = leaf->count.load(std::memory_order_relaxed);
+    int pos = lower_bound(leaf->keys, n, k);
+    bool found = pos < n && !comp_(k, leaf->keys[pos]);
+    leaf->latch.validate(version, &restart);
+    if (restart) {
+      continue;
+    }
+    if (found) {
+      return false;
+    }
+    if (n == kLeafValues) {
+      split(parent, parent_version, leaf, version);
+      continue;
+    }
+
+    leaf->latch.upgrade(&version, &restart);
+    if (restart) {
+      continue;
+    }
+    // The leaf may have been split between reading its pointer and its
+    // version, and then k belongs in the new sibling.
+    if (parent) {
+      parent->latch.validate(parent_version, &restart);
+      if (restart) {
+        leaf->latch.unlock();
+        continue;
+      }
+    }
+    memmove(leaf->keys + pos + 1, leaf->keys + pos,
+            (n - pos) * sizeof(key_type));
+    leaf->data.move(pos + 1, leaf->data, pos, n - pos);
+    leaf->keys[pos] = k;
+    store(leaf->data, pos);
+    leaf->count.store(n + 1, std::memory_order_relaxed);
+    leaf->latch.unlock();
+    return true;
+  }
+}
+
+template <typename K, typename D, typename C, int N>
+template <typename Load>
+bool olc_btree<K, D, C, N>::find_unique(const key_type &k, Load load) const {
+  for (;;) {
+    bool restart = false;
+    uint64_t version, parent_version;
+    internal_type *parent;
+    node_type *node = descend(k, false, &version, &parent, &parent_version);
+    if (!node) {
+      continue;
+    }
+
+    leaf_type *leaf = as_leaf(node);
+    int n = leaf->count.load(std::memory_order_relaxed);
+    int pos = lower_bound(leaf->keys, n, k);
+    bool found = pos < n && !comp_(k, leaf->keys[pos]);
+    if (found) {
+      load(leaf->data, pos);
+    }
+    if (parent) {
+      parent->latch.validate(parent_version, &restart);
+    }
+    leaf->latch.validate(version, &restart);
+    if (!restart) {
+      return found;
+    }
+  }
+}
+
+template <typename K, typename D, typename C, int N>
+bool olc_btree<K, D, C, N>::erase_unique(const key_type &k) {
+  for (;;) {
+    bool restart = false;
+    uint64_t version, parent_version;
+    internal_type *parent;
+    node_type *node = descend(k, false, &version, &parent, &parent_version);
+    if (!node) {
+      continue;
+    }
+
+    leaf_type *leaf = as_leaf(node);
+    int n = leaf->count.load(std::memory_order_relaxed);
+    int pos = lower_bound(leaf->keys, n, k);
+    bool found = pos < n && !comp_(k, leaf->keys[pos]);
+    if (!found) {
+      if (parent) {
+        parent->latch.validate(parent_version, &restart);
+      }
+      leaf->latch.validate(version, &restart);
+      if (restart) {
+        continue;
+      }
+      return false;
+    }
+
+    leaf->latch.upgrade(&version, &restart);
+    if (restart) {
+      continue;
+    }
+    memmove(leaf->keys + pos, leaf->keys + pos + 1,
+            (n - pos - 1) * sizeof(key_type));
+    leaf->data.move(pos, leaf->data, pos + 1, n - pos - 1);
+    leaf->count.store(n - 1, std::memory_order_relaxed);
+    leaf->latch.unlock();
+    return true;
+  }
+}
+
+template <typename K, typename D, typename C, int N>
+typename olc_btree<K, D, C, N>::node_type*
+olc_btree<K, D, C, N>::descend(const key_type &k, bool stop_at_full,
+                               uint64_t *version, internal_type **parent,
+                               uint64_t *parent_version) const {
+  bool restart = false;
+  node_type *node = root_.load(std::memory_order_acquire);
+  *version = node->latch.read_lock(&restart);
+  // A root split after loading root_ leaves node covering only part of the
+  // keys, with nothing above it to notice.
+  if (restart || node != root_.load(std::memory_order_acquire)) {
+    return NULL;
+  }
+  *parent = NULL;
+  *parent_version = 0;
+  while (!node->leaf) {
+    internal_type *inner = as_internal(node);
+    int n = inner->count.load(std::memory_order_relaxed);
+    if (stop_at_full && n == kInternalValues) {
+      return node;
+    }
+    if (*parent) {
+      (*parent)->latch.validate(*parent_version, &restart);
+    }
+    *parent = inner;
+    *parent_version = *version;
+    node = inner->children[lower_bound(inner->keys, n, k)];
+    // Only follow the pointer once it is known to be one inner really held.
+    inner->latch.validate(*version, &restart);
+    if (restart) {
+      return NULL;
+    }
+    *version = node->latch.read_lock(&restart);
+    if (restart) {
+      return NULL;
+    }
+  }
+  return node;
+}
+
+template <typename K, typename D, typename C, int N>
+void olc_btree<K, D, C, N>::split(internal_type *parent,
+                                  uint64_t parent_version,
+                                  node_type *node, uint64_t version) {
+  bool restart = false;
+  if (parent) {
+    parent->latch.upgrade(&parent_version, &restart);
+    if (restart) {
+      return;
+    }
+  }
+  node->latch.upgrade(&version, &restart);
+  if (restart) {
+    if (parent) {
+      parent->latch.unlock();
+    }
+    return;
+  }
+  if (!parent && node != root_.load(std::memory_order_relaxed)) {
+    // Someone else split the root first.
+    node->latch.unlock();
+    return;
+  }
+
+  key_type separator;
+  node_type *sibling;
+  int n = node->count.load(std::memory_order_relaxed);
+  if (node->leaf) {
+    leaf_type *left = as_leaf(node);
+    leaf_type *right = new leaf_type;
+    int mid = n / 2;
+    memcpy(right->keys, left->keys + mid, (n - mid) * sizeof(key_type));
+    right->data.move(0, left->data, mid, n - mid);
+    right->count.store(n - mid, std::memory_order_relaxed);
+    left->count.store(mid, std::memory_order_relaxed);
+    separator = left->keys[mid - 1];
+    sibling = right;
+  } else {
+    internal_type *left = as_internal(node);
+    internal_type *right = new internal_type;
+    int mid = n / 2;
+    memcpy(right->keys, left->keys + mid + 1,
+           (n - mid - 1) * sizeof(key_type));
+    memcpy(right->children, left->children + mid + 1,
+           (n - mid) * sizeof(node_type*));
+    right->count.store(n - mid - 1, std::memory_order_relaxed);
+    left->count.store(mid, std::memory_order_relaxed);
+    separator = left->keys[mid];
+    sibling = right;
+  }
+
+  if (parent) {
+    // parent had room when this descent passed it, and it has not changed
+    // since or the latch would not have been granted.
+    int pn = parent->count.load(std::memory_order_relaxed);
+    int pos = lower_bound(parent->keys, pn, separator);
+    memmove(parent->keys + pos + 1, parent->keys + pos,
+            (pn - pos) * sizeof(key_type));
+    memmove(parent->children + pos + 2, parent->children + pos + 1,
+            (pn - pos) * sizeof(node_type*));
+    parent->keys[pos] = separator;
+    parent->children[pos + 1] = sibling;
+    parent->count.store(pn + 1, std::memory_order_relaxed);
+  } else {
+    internal_type *root = new internal_type;
+    root->keys[0] = separator;
+    root->children[0] = node;
+    root->children[1] = sibling;
+    root->count.store(1, std::memory_order_relaxed);
+    root_.store(root, std::memory_order_release);
+  }
+  node->latch.unlock();
+  if (parent) {
+    parent->latch.unlock();
+  }
+}
+
+template <typename K, typename D, typename C, int N>
+void olc_btree<K, D, C, N>::internal_clear(node_type *node) {
+  if (node->leaf) {
+    delete as_leaf(node);
+    return;
+  }
+  internal_type *inner = as_internal(node);
+  for (int i = 0; i <= inner->count.load(std::memory_order_relaxed); ++i) {
+    internal_clear(inner->children[i]);
+  }
+  delete inner;
+}
+
+template <typename K, typename D, typename C, int N>
+typename olc_btree<K, D, C, N>::size_type
+olc_btree<K, D, C, N>::internal_size(const node_type *node) const {
+  int n = node->count.load(std::memory_order_relaxed);
+  if (node->leaf) {
+    return n;
+  }
+  const internal_type *inner = static_cast<const internal_type*>(node);
+  size_type size = 0;
+  for (int i = 0; i <= n; ++i) {
+    size += internal_size(inner->children[i]);
+  }
+  return size;
+}
+
+template <typename K, typename D, typename C, int N>
+void olc_btree<K, D, C, N>::internal_verify(
+    const node_type *node, const key_type *lo, const key_type *hi) const {
+  int n = node->count.load(std::memory_order_relaxed);
+  const key_type *keys = node->leaf
+      ? static_cast<const leaf_type*>(node)->keys
+      : static_cast<const internal_type*>(node)->keys;
+  assert(n <= (node->leaf ? int(kLeafValues) : int(kInternalValues)));
+  for (int i = 0; i < n; ++i) {
+    assert(i == 0 || comp_(keys[i - 1], keys[i]));
+    assert(!lo || comp_(*lo, keys[i]));
+    assert(!hi || !comp_(*hi, keys[i]));
+  }
+  if (node->leaf) {
+    return;
+  }
+  const internal_type *inner = static_cast<const internal_type*>(node);
+  for (int i = 0; i <= n; ++i) {
+    internal_verify(inner->children[i],
+                    i == 0 ? lo : &keys[i - 1],
+                    i == n ? hi : &keys[i]);
+  }
+}
+
+} // namespace btree
+
+#endif  // UTIL_BTREE_OLC_BTREE_H__
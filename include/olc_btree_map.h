@@ -0,0 +1,90 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// An olc_btree_map<> is a map that many threads can insert into, erase from
+// and look up in at once, without a lock around it. See olc_btree.h for how
+// and for the caveats. Values are copied out by find() rather than referenced,
+// since another thread may move them at any time.
+
+#ifndef UTIL_BTREE_OLC_BTREE_MAP_H__
+#define UTIL_BTREE_OLC_BTREE_MAP_H__
+
+#include <functional>
+
+#include "olc_btree.h"
+
+namespace btree {
+
+template <typename Key, typename Value,
+          typename Compare = std::less<Key>,
+          int TargetNodeSize = 256>
+class olc_btree_map {
+  typedef olc_btree<Key, Value, Compare, TargetNodeSize> tree_type;
+  typedef typename tree_type::leaf_data leaf_data;
+
+ public:
+  typedef Key key_type;
+  typedef Value mapped_type;
+  typedef Compare key_compare;
+  typedef typename tree_type::size_type size_type;
+
+ public:
+  explicit olc_btree_map(const key_compare &comp = key_compare())
+      : tree_(comp) {
+  }
+
+  // Inserts key with value unless key is present, and returns whether it
+  // was inserted.
+  bool insert(const key_type &key, const mapped_type &value) {
+    return tree_.insert_unique(key, [&value](leaf_data &data, int i) {
+        data.values[i] = value;
+      });
+  }
+  bool erase(const key_type &key) {
+    return tree_.erase_unique(key);
+  }
+
+  // Copies the value for key to *value and returns true, or returns false if
+  // key is not present.
+  bool find(const key_type &key, mapped_type *value) const {
+    return tree_.find_unique(key, [value](const leaf_data &data, int i) {
+        *value = data.values[i];
+      });
+  }
+  bool contains(const key_type &key) const {
+    return tree_.contains(key);
+  }
+  size_type count(const key_type &key) const {
+    return tree_.contains(key) ? 1 : 0;
+  }
+
+  // Only exact while no other thread writes.
+  size_type size() const { return tree_.size(); }
+  bool empty() const { return tree_.empty(); }
+  void verify() const { tree_.verify(); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+ private:
+  tree_type tree_;
+};
+
+} // namespace btree
+
+#endif  // UTIL_BTREE_OLC_BTREE_MAP_H__
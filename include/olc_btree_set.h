@@ -0,0 +1,78 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// An olc_btree_set<> is a set that many threads can insert into, erase from
+// and look up in at once, without a lock around it. See olc_btree.h for how
+// and for the caveats. Without iterators it only offers the point operations,
+// and insert() returns just whether the key was new.
+
+#ifndef UTIL_BTREE_OLC_BTREE_SET_H__
+#define UTIL_BTREE_OLC_BTREE_SET_H__
+
+#include <functional>
+
+#include "olc_btree.h"
+
+namespace btree {
+
+template <typename Key,
+          typename Compare = std::less<Key>,
+          int TargetNodeSize = 256>
+class olc_btree_set {
+  typedef olc_btree<Key, void, Compare, TargetNodeSize> tree_type;
+  typedef typename tree_type::leaf_data leaf_data;
+
+ public:
+  typedef Key key_type;
+  typedef Key value_type;
+  typedef Compare key_compare;
+  typedef typename tree_type::size_type size_type;
+
+ public:
+  explicit olc_btree_set(const key_compare &comp = key_compare())
+      : tree_(comp) {
+  }
+
+  bool insert(const key_type &key) {
+    return tree_.insert_unique(key, [](leaf_data&, int) {});
+  }
+  bool erase(const key_type &key) {
+    return tree_.erase_unique(key);
+  }
+  bool contains(const key_type &key) const {
+    return tree_.contains(key);
+  }
+  size_type count(const key_type &key) const {
+    return tree_.contains(key) ? 1 : 0;
+  }
+
+  // Only exact while no other thread writes.
+  size_type size() const { return tree_.size(); }
+  bool empty() const { return tree_.empty(); }
+  void verify() const { tree_.verify(); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+ private:
+  tree_type tree_;
+};
+
+} // namespace btree
+
+#endif  // UTIL_BTREE_OLC_BTREE_SET_H__
@@ -0,0 +1,178 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_PERF_COUNTERS_HPP
+#define c6d28b7452ec699b_PERF_COUNTERS_HPP
+
+#include <stdint.h>
+#include <cstring>
+#include <limits>
+#ifdef __linux__
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+/*
+ * Hardware performance counters via Linux perf_event_open(2), read around
+ * each timed region alongside getticks(). Each event is opened on its own so
+ * that a PMU with few programmable counters multiplexes them; the readings
+ * are scaled by time enabled / time running. On other platforms, or when the
+ * kernel refuses (see /proc/sys/kernel/perf_event_paranoid), open() fails and
+ * nothing is measured.
+ */
+namespace bench {
+
+enum {
+	PERF_INSTRUCTIONS,
+	PERF_CYCLES,
+	PERF_BRANCH_MISSES,
+	PERF_L1D_MISSES,
+	PERF_LLC_MISSES,
+	PERF_DTLB_MISSES,
+	PERF_NUM,
+};
+
+inline const char *perf_name(size_t i) {
+	static const char *names[PERF_NUM] = {
+		"instructions",
+		"cycles",
+		"branch-misses",
+		"L1d-misses",
+		"LLC-misses",
+		"dTLB-misses",
+	};
+	return names[i];
+}
+
+// One reading per event; NaN where the event is not available
+struct PerfValues {
+	double v[PERF_NUM];
+
+	PerfValues() {
+		for (size_t i = 0; i < PERF_NUM; ++i) {
+			v[i] = std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+
+	PerfValues operator-(const PerfValues& o) const {
+		PerfValues rv;
+		for (size_t i = 0; i < PERF_NUM; ++i) {
+			rv.v[i] = v[i] - o.v[i];
+		}
+		return rv;
+	}
+};
+
+class PerfCounters {
+public:
+	PerfCounters() {
+		for (size_t i = 0; i < PERF_NUM; ++i) {
+			fds[i] = -1;
+		}
+	}
+
+	~PerfCounters() {
+		close();
+	}
+
+	// Opens whichever events the kernel and PMU allow; true if any opened
+	bool open() {
+		bool any = false;
+#ifdef __linux__
+		const uint32_t types[PERF_NUM] = {
+			PERF_TYPE_HARDWARE,
+			PERF_TYPE_HARDWARE,
+			PERF_TYPE_HARDWARE,
+			PERF_TYPE_HW_CACHE,
+			PERF_TYPE_HW_CACHE,
+			PERF_TYPE_HW_CACHE,
+		};
+		const uint64_t configs[PERF_NUM] = {
+			PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CPU_CYCLES,
+			PERF_COUNT_HW_BRANCH_MISSES,
+			PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+			PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+			PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+		};
+		for (size_t i = 0; i < PERF_NUM; ++i) {
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = types[i];
+			attr.config = configs[i];
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+			if (fds[i] >= 0) {
+				ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+				ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+				any = true;
+			}
+		}
+#endif
+		return any;
+	}
+
+	void close() {
+		for (size_t i = 0; i < PERF_NUM; ++i) {
+#ifdef __linux__
+			if (fds[i] >= 0) {
+				::close(fds[i]);
+			}
+#endif
+			fds[i] = -1;
+		}
+	}
+
+	bool available(size_t i) const {
+		return fds[i] >= 0;
+	}
+
+	void read(PerfValues& out) const {
+#ifdef __linux__
+		for (size_t i = 0; i < PERF_NUM; ++i) {
+			if (fds[i] < 0) {
+				continue;
+			}
+			uint64_t buf[3] = {};
+			if (::read(fds[i], buf, sizeof(buf)) != sizeof(buf) || buf[2] == 0) {
+				continue;
+			}
+			out.v[i] = double(buf[0]) * (double(buf[1]) / double(buf[2]));
+		}
+#else
+		(void)out;
+#endif
+	}
+
+private:
+	int fds[PERF_NUM];
+
+	PerfCounters(const PerfCounters&);
+	PerfCounters& operator=(const PerfCounters&);
+};
+
+}
+
+#endif
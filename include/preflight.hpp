@@ -0,0 +1,146 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_PREFLIGHT_HPP
+#define c6d28b7452ec699b_PREFLIGHT_HPP
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+	#include <sched.h>
+#endif
+
+/*
+ * Pins the benchmark thread and inspects the things that make timings noisy:
+ * the cpufreq governor, turbo/boost, and whether the chosen core shares its
+ * execution units with an SMT sibling. Everything found is kept for the
+ * result metadata, and anything that hurts stability becomes a warning.
+ */
+namespace bench {
+
+// First line of a sysfs/procfs file, or empty if it can't be read
+inline std::string read_line(const std::string& fname) {
+	std::ifstream in(fname.c_str());
+	std::string line;
+	std::getline(in, line);
+	return line;
+}
+
+struct Environment {
+	// CPU the thread is pinned to, or -1
+	int cpu;
+	// "fifo" if raised to SCHED_FIFO, otherwise "other"
+	std::string scheduler;
+	std::string governor;
+	// "on", "off" or "unknown"
+	std::string turbo;
+	// "on", "off" or "unknown"
+	std::string smt;
+	// CPUs sharing a core with the pinned one (or CPU 0), as listed by sysfs
+	std::string siblings;
+	std::vector<std::string> warnings;
+
+	Environment() : cpu(-1), scheduler("other"), turbo("unknown"), smt("unknown") {
+	}
+};
+
+// Pins to cpu (if >= 0), optionally switches to SCHED_FIFO, and inspects the
+// rest of the environment
+inline Environment preflight(int cpu = -1, bool fifo = false) {
+	Environment env;
+
+#ifdef __linux__
+	if (cpu >= 0) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		if (sched_setaffinity(0, sizeof(set), &set) == 0) {
+			env.cpu = cpu;
+		}
+		else {
+			env.warnings.push_back("could not pin to CPU " + std::to_string(cpu));
+		}
+	}
+
+	if (fifo) {
+		sched_param sp;
+		sp.sched_priority = sched_get_priority_max(SCHED_FIFO);
+		if (sched_setscheduler(0, SCHED_FIFO, &sp) == 0) {
+			env.scheduler = "fifo";
+		}
+		else {
+			env.warnings.push_back("could not switch to SCHED_FIFO (needs CAP_SYS_NICE)");
+		}
+	}
+
+	std::ostringstream base;
+	base << "/sys/devices/system/cpu/cpu" << (env.cpu >= 0 ? env.cpu : 0);
+
+	env.governor = read_line(base.str() + "/cpufreq/scaling_governor");
+	if (!env.governor.empty() && env.governor != "performance") {
+		env.warnings.push_back("cpufreq governor is " + env.governor + ", not performance");
+	}
+
+	std::string no_turbo = read_line("/sys/devices/system/cpu/intel_pstate/no_turbo");
+	std::string boost = read_line("/sys/devices/system/cpu/cpufreq/boost");
+	if (!no_turbo.empty()) {
+		env.turbo = (no_turbo == "1") ? "off" : "on";
+	}
+	else if (!boost.empty()) {
+		env.turbo = (boost == "1") ? "on" : "off";
+	}
+	if (env.turbo == "on") {
+		env.warnings.push_back("turbo/boost is enabled, clock speed will vary with load and temperature");
+	}
+
+	std::string smt = read_line("/sys/devices/system/cpu/smt/active");
+	if (!smt.empty()) {
+		env.smt = (smt == "1") ? "on" : "off";
+	}
+	env.siblings = read_line(base.str() + "/topology/thread_siblings_list");
+	if (env.siblings.find_first_of(",-") != std::string::npos) {
+		env.warnings.push_back("CPU shares a core with SMT siblings " + env.siblings + ", keep them idle");
+	}
+#else
+	(void)fifo;
+	if (cpu >= 0) {
+		env.warnings.push_back("CPU pinning is only supported on Linux");
+	}
+#endif
+
+	return env;
+}
+
+// Adds the warning for not asking to be pinned. The Runner adds it at the
+// first run(), once the benchmark has had the chance to say that it runs
+// worker threads, which --cpu would pin all to one CPU.
+inline void warn_unpinned(Environment& env) {
+#ifdef __linux__
+	env.warnings.push_back("not pinned to a CPU, use --cpu N");
+#else
+	(void)env;
+#endif
+}
+
+}
+
+#endif
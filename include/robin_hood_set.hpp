@@ -0,0 +1,456 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_ROBIN_HOOD_SET_HPP
+#define c6d28b7452ec699b_ROBIN_HOOD_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*
+ * An open addressing hash set with linear probing and Robin Hood insertion:
+ * an element being inserted takes the slot of any element it meets that is
+ * closer to its own home slot, and that element moves on instead. This
+ * evens out how far elements sit from home, keeping lookups short even at
+ * load factors of 0.9 and above, and a lookup can stop as soon as it meets
+ * an element closer to home than the key it looks for would be.
+ *
+ * Each slot has one byte: 0 if empty, else the element's displacement from
+ * its home slot plus 1. The table grows when the max load factor would be
+ * exceeded or a displacement would not fit in the byte. If the latter happens
+ * with the table less than 1/8 full, the hash function puts too many keys in
+ * the same place for growing to help, and insert() throws
+ * std::overflow_error, leaving the set as it was. Erasing shifts the elements
+ * after the hole back by one until one is at home, so there are no
+ * tombstones. Inserting or erasing invalidates iterators.
+ */
+namespace bench {
+
+// How far elements sit from their home slots; a lookup that hits probes the
+// displacement plus 1 slots
+struct ProbeStats {
+	double average;
+	size_t max;
+	// Number of elements at each displacement
+	std::vector<size_t> histogram;
+};
+
+template<typename T, typename Hash = std::hash<T>, typename Eq = std::equal_to<T>, typename Alloc = std::allocator<T> >
+class robin_hood_set {
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<uint8_t> meta_allocator;
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<T> slot_allocator;
+
+	// The largest displacement plus 1 a slot can record
+	static const uint8_t MAX_DIST = 255;
+
+public:
+	typedef T value_type;
+	typedef T key_type;
+	typedef size_t size_type;
+	typedef Hash hasher;
+	typedef Eq key_equal;
+	typedef Alloc allocator_type;
+
+	class const_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const T *pointer;
+		typedef const T& reference;
+
+		const_iterator() : meta(0), end(0), slot(0) {
+		}
+
+		reference operator*() const {
+			return *slot;
+		}
+
+		pointer operator->() const {
+			return slot;
+		}
+
+		const_iterator& operator++() {
+			++meta;
+			++slot;
+			skip();
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			const_iterator rv = *this;
+			++*this;
+			return rv;
+		}
+
+		bool operator==(const const_iterator& o) const {
+			return slot == o.slot;
+		}
+
+		bool operator!=(const const_iterator& o) const {
+			return slot != o.slot;
+		}
+
+	private:
+		friend class robin_hood_set;
+
+		const_iterator(const uint8_t *meta, const uint8_t *end, const T *slot) : meta(meta), end(end), slot(slot) {
+		}
+
+		void skip() {
+			while (meta != end && *meta == 0) {
+				++meta;
+				++slot;
+			}
+		}
+
+		const uint8_t *meta;
+		const uint8_t *end;
+		const T *slot;
+	};
+	typedef const_iterator iterator;
+
+	explicit robin_hood_set(double max_load = 0.9, const Alloc& alloc = Alloc()) : alloc(alloc), meta(0), slots(0), mask(0), elements(0), max_load(0.9) {
+		max_load_factor(max_load);
+	}
+
+	robin_hood_set(const robin_hood_set& o) : hash(o.hash), eq(o.eq), alloc(o.alloc), meta(0), slots(0), mask(0), elements(0), max_load(o.max_load) {
+		reserve(o.size());
+		for (const_iterator it = o.begin(); it != o.end(); ++it) {
+			insert(*it);
+		}
+	}
+
+	robin_hood_set(robin_hood_set&& o) : hash(o.hash), eq(o.eq), alloc(o.alloc), meta(o.meta), slots(o.slots), mask(o.mask), elements(o.elements), max_load(o.max_load) {
+		o.meta = 0;
+		o.slots = 0;
+		o.mask = 0;
+		o.elements = 0;
+	}
+
+	robin_hood_set& operator=(robin_hood_set o) {
+		swap(o);
+		return *this;
+	}
+
+	~robin_hood_set() {
+		release();
+	}
+
+	void swap(robin_hood_set& o) {
+		std::swap(hash, o.hash);
+		std::swap(eq, o.eq);
+		std::swap(alloc, o.alloc);
+		std::swap(meta, o.meta);
+		std::swap(slots, o.slots);
+		std::swap(mask, o.mask);
+		std::swap(elements, o.elements);
+		std::swap(max_load, o.max_load);
+	}
+
+	size_type size() const {
+		return elements;
+	}
+
+	bool empty() const {
+		return elements == 0;
+	}
+
+	size_type capacity() const {
+		return meta ? mask + 1 : 0;
+	}
+
+	double load_factor() const {
+		return meta ? double(elements) / double(capacity()) : 0.0;
+	}
+
+	double max_load_factor() const {
+		return max_load;
+	}
+
+	// Takes effect from the next insert; throws std::invalid_argument unless
+	// 0 < ml <= 1
+	void max_load_factor(double ml) {
+		if (!(ml > 0.0 && ml <= 1.0)) {
+			throw std::invalid_argument("max load factor must be above 0 and at most 1");
+		}
+		max_load = ml;
+	}
+
+	const_iterator begin() const {
+		if (!meta) {
+			return end();
+		}
+		const_iterator it(meta, meta + capacity(), slots);
+		it.skip();
+		return it;
+	}
+
+	const_iterator end() const {
+		return const_iterator(meta + capacity(), meta + capacity(), slots + capacity());
+	}
+
+	const_iterator find(const T& v) const {
+		size_t pos = locate(v);
+		if (pos == npos()) {
+			return end();
+		}
+		return const_iterator(meta + pos, meta + capacity(), slots + pos);
+	}
+
+	size_type count(const T& v) const {
+		return locate(v) != npos();
+	}
+
+	bool contains(const T& v) const {
+		return locate(v) != npos();
+	}
+
+	std::pair<const_iterator, bool> insert(const T& v) {
+		size_t pos = locate(v);
+		if (pos != npos()) {
+			return std::make_pair(const_iterator(meta + pos, meta + capacity(), slots + pos), false);
+		}
+		grow_for(elements + 1);
+		pos = place(v);
+		++elements;
+		return std::make_pair(const_iterator(meta + pos, meta + capacity(), slots + pos), true);
+	}
+
+	template<typename InputIterator>
+	void insert(InputIterator b, InputIterator e) {
+		for (; b != e; ++b) {
+			insert(*b);
+		}
+	}
+
+	size_type erase(const T& v) {
+		size_t pos = locate(v);
+		if (pos == npos()) {
+			return 0;
+		}
+		slots[pos].~T();
+		size_t next = (pos + 1) & mask;
+		while (meta[next] > 1) {
+			new (slots + pos) T(std::move(slots[next]));
+			slots[next].~T();
+			meta[pos] = uint8_t(meta[next] - 1);
+			pos = next;
+			next = (next + 1) & mask;
+		}
+		meta[pos] = 0;
+		--elements;
+		return 1;
+	}
+
+	void clear() {
+		for (size_t i = 0; i < capacity(); ++i) {
+			if (meta[i]) {
+				slots[i].~T();
+			}
+		}
+		if (meta) {
+			std::memset(meta, 0, capacity());
+		}
+		elements = 0;
+	}
+
+	// Makes room for n elements without growing
+	void reserve(size_type n) {
+		grow_for(n);
+	}
+
+	ProbeStats probe_stats() const {
+		ProbeStats rv = { 0.0, 0, std::vector<size_t>() };
+		size_t total = 0;
+		for (size_t i = 0; i < capacity(); ++i) {
+			if (!meta[i]) {
+				continue;
+			}
+			size_t d = meta[i] - 1u;
+			if (d >= rv.histogram.size()) {
+				rv.histogram.resize(d + 1, 0);
+			}
+			++rv.histogram[d];
+			total += d;
+			if (d > rv.max) {
+				rv.max = d;
+			}
+		}
+		if (elements) {
+			rv.average = double(total) / double(elements);
+		}
+		return rv;
+	}
+
+	hasher hash_function() const {
+		return hash;
+	}
+
+	key_equal key_eq() const {
+		return eq;
+	}
+
+	allocator_type get_allocator() const {
+		return alloc;
+	}
+
+private:
+	static size_t npos() {
+		return size_t(-1);
+	}
+
+	// Spreads the hash over all bits, since std::hash of integers is the
+	// identity
+	size_t home(const T& v) const {
+		uint64_t m = uint64_t(hash(v)) * 0x9E3779B97F4A7C15ull;
+		return size_t(m ^ (m >> 32)) & mask;
+	}
+
+	// Stops at the first slot whose element is closer to home than v would
+	// be there; only elements exactly as far from home as v share its home
+	size_t locate(const T& v) const {
+		if (!meta) {
+			return npos();
+		}
+		size_t i = home(v);
+		for (uint8_t d = 1; meta[i] >= d; ++d) {
+			if (meta[i] == d && eq(slots[i], v)) {
+				return i;
+			}
+			i = (i + 1) & mask;
+		}
+		return npos();
+	}
+
+	// Inserts v, which is not present, and returns its slot. v goes where
+	// the first element closer to its home than v would be sits, and the run
+	// from there to the next empty slot moves one slot on. Nothing is moved
+	// until it is known that no displacement overflows; if one would, the
+	// table grows first, or with rehashing set keeps growing rather than throw
+	// halfway through moving the elements over.
+	size_t place(T v, bool rehashing = false) {
+		for (;;) {
+			size_t i = home(v);
+			uint8_t d = 1;
+			while (meta[i] >= d && d < MAX_DIST) {
+				i = (i + 1) & mask;
+				++d;
+			}
+			bool fits = (d < MAX_DIST);
+			size_t e = i;
+			while (fits && meta[e]) {
+				fits = (meta[e] < MAX_DIST - 1);
+				e = (e + 1) & mask;
+			}
+			if (fits) {
+				for (size_t j = e; j != i; j = (j - 1) & mask) {
+					size_t prev = (j - 1) & mask;
+					new (slots + j) T(std::move(slots[prev]));
+					slots[prev].~T();
+					meta[j] = uint8_t(meta[prev] + 1);
+				}
+				new (slots + i) T(std::move(v));
+				meta[i] = d;
+				return i;
+			}
+			if (!rehashing && elements < capacity() / 8) {
+				throw std::overflow_error("robin_hood_set: too many keys hash alike");
+			}
+			rehash(capacity() * 2);
+		}
+	}
+
+	// Grows the table until n elements fit under the max load factor
+	void grow_for(size_type n) {
+		size_t cap = capacity();
+		if (cap && double(n) <= double(cap) * max_load) {
+			return;
+		}
+		if (cap == 0) {
+			cap = 16;
+		}
+		while (double(n) > double(cap) * max_load) {
+			cap *= 2;
+		}
+		if (cap != capacity()) {
+			rehash(cap);
+		}
+	}
+
+	void rehash(size_t cap) {
+		uint8_t *old_meta = meta;
+		T *old_slots = slots;
+		size_t old_cap = capacity();
+
+		meta_allocator ma(alloc);
+		slot_allocator sa(alloc);
+		meta = ma.allocate(cap);
+		slots = sa.allocate(cap);
+		std::memset(meta, 0, cap);
+		mask = cap - 1;
+
+		for (size_t i = 0; i < old_cap; ++i) {
+			if (old_meta[i]) {
+				place(std::move(old_slots[i]), true);
+				old_slots[i].~T();
+			}
+		}
+		if (old_meta) {
+			ma.deallocate(old_meta, old_cap);
+			sa.deallocate(old_slots, old_cap);
+		}
+	}
+
+	void release() {
+		if (!meta) {
+			return;
+		}
+		clear();
+		meta_allocator ma(alloc);
+		slot_allocator sa(alloc);
+		ma.deallocate(meta, capacity());
+		sa.deallocate(slots, capacity());
+		meta = 0;
+		slots = 0;
+		mask = 0;
+	}
+
+	Hash hash;
+	Eq eq;
+	Alloc alloc;
+	uint8_t *meta;
+	T *slots;
+	size_t mask;
+	size_t elements;
+	double max_load;
+};
+
+}
+
+#endif
@@ -0,0 +1,286 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_STATIC_BTREE_SET_HPP
+#define c6d28b7452ec699b_STATIC_BTREE_SET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*
+ * A read-only sorted set built once from sorted input, laid out as a static
+ * B+ tree (an S+ tree): the keys sorted in one array, cut into nodes of B
+ * keys, under layers of internal nodes of B keys and B+1 children, all in
+ * one allocation with the root first. There are no child pointers; child j
+ * of node i is node i*(B+1)+j of the next layer. Key j of an internal node is
+ * the first key under child j+1.
+ *
+ * By default a node is one cache line of keys, so a lookup touches one line
+ * per layer, about log(N)/log(B+1) of them against log2(N) for a binary
+ * search. Within a node it counts the keys less than the one looked for
+ * instead of searching, which has no branches to mispredict and which the
+ * compiler can vectorise for integers.
+ *
+ * The last leaf is padded with copies of the largest key, and so are the
+ * keys of internal nodes for children past the end, so every node is full.
+ * Iterating walks the sorted array.
+ */
+namespace bench {
+
+template<typename T, typename Compare = std::less<T>, size_t B = (sizeof(T) <= 32 ? 64 / sizeof(T) : 2)>
+class static_btree_set {
+public:
+	typedef T value_type;
+	typedef T key_type;
+	typedef size_t size_type;
+	typedef Compare key_compare;
+	typedef const T *const_iterator;
+	typedef const_iterator iterator;
+
+	explicit static_btree_set(const Compare& comp = Compare()) : keys(0), slots(0), elements(0), comp(comp) {
+	}
+
+	// [first, last) must be sorted and without duplicates
+	template<typename ForwardIterator>
+	static_btree_set(ForwardIterator first, ForwardIterator last, const Compare& comp = Compare()) : keys(0), slots(0), elements(0), comp(comp) {
+		assign(first, last);
+	}
+
+	static_btree_set(const static_btree_set& o) : keys(0), slots(0), elements(0), comp(o.comp) {
+		if (o.slots) {
+			keys = allocate(o.slots);
+			std::uninitialized_copy(o.keys, o.keys + o.slots, keys);
+			slots = o.slots;
+			elements = o.elements;
+			layers = o.layers;
+		}
+	}
+
+	static_btree_set(static_btree_set&& o) noexcept : keys(o.keys), slots(o.slots), elements(o.elements), layers(std::move(o.layers)), comp(o.comp) {
+		o.keys = 0;
+		o.slots = 0;
+		o.elements = 0;
+		o.layers.clear();
+	}
+
+	static_btree_set& operator=(static_btree_set o) {
+		swap(o);
+		return *this;
+	}
+
+	~static_btree_set() {
+		release();
+	}
+
+	void swap(static_btree_set& o) {
+		std::swap(keys, o.keys);
+		std::swap(slots, o.slots);
+		std::swap(elements, o.elements);
+		layers.swap(o.layers);
+		std::swap(comp, o.comp);
+	}
+
+	// Replaces the contents with [first, last), which must be sorted and
+	// without duplicates
+	template<typename ForwardIterator>
+	void assign(ForwardIterator first, ForwardIterator last) {
+		const Compare& c = comp;
+		if (std::adjacent_find(first, last, [&c](const T& a, const T& b) { return !c(a, b); }) != last) {
+			throw std::invalid_argument("static_btree_set: input must be sorted and without duplicates");
+		}
+		release();
+		const size_t n = size_t(std::distance(first, last));
+		if (n == 0) {
+			return;
+		}
+
+		// Node counts from the leaves up, then laid out from the root down
+		std::vector<Layer> ls;
+		Layer leaf = { 0, (n + B - 1) / B, 1 };
+		ls.push_back(leaf);
+		while (ls.back().nodes > 1) {
+			Layer up = { 0, (ls.back().nodes + B) / (B + 1), ls.back().span * (B + 1) };
+			ls.push_back(up);
+		}
+		std::reverse(ls.begin(), ls.end());
+		size_t total = 0;
+		for (size_t h = 0; h < ls.size(); ++h) {
+			ls[h].offset = total;
+			total += ls[h].nodes * B;
+		}
+
+		T *k = allocate(total);
+		T *sorted = k + ls.back().offset;
+		size_t built = 0;
+		try {
+			// The leaves first, since the internal keys are copied from them
+			for (; first != last; ++first, ++built) {
+				new (sorted + built) T(*first);
+			}
+			for (; built < ls.back().nodes * B; ++built) {
+				new (sorted + built) T(sorted[n - 1]);
+			}
+			for (size_t h = 0; h + 1 < ls.size(); ++h) {
+				const size_t child_span = ls[h + 1].span;
+				for (size_t i = 0; i < ls[h].nodes * B; ++i) {
+					const size_t child = (i / B) * (B + 1) + i % B + 1;
+					const size_t first_key = child * child_span * B;
+					new (k + ls[h].offset + i) T(sorted[std::min(first_key, n - 1)]);
+					++built;
+				}
+			}
+		}
+		catch (...) {
+			// Built are the leaves, then the internal keys from the root on
+			const size_t leaves = std::min(built, ls.back().nodes * B);
+			for (size_t i = 0; i < leaves; ++i) {
+				sorted[i].~T();
+			}
+			for (size_t i = 0; i < built - leaves; ++i) {
+				k[i].~T();
+			}
+			deallocate(k);
+			throw;
+		}
+		keys = k;
+		slots = total;
+		elements = n;
+		layers.swap(ls);
+	}
+
+	size_type size() const {
+		return elements;
+	}
+
+	bool empty() const {
+		return elements == 0;
+	}
+
+	void clear() {
+		release();
+	}
+
+	const_iterator begin() const {
+		return layers.empty() ? 0 : keys + layers.back().offset;
+	}
+
+	const_iterator end() const {
+		return begin() + elements;
+	}
+
+	// Goes down the child holding the first key not less than v, but never
+	// past the last node of a layer, so that a v above every key ends at the
+	// end. Falling off the end of a leaf lands on the first key of the next
+	// one, which is where the lower bound is then.
+	const_iterator lower_bound(const T& v) const {
+		if (!elements) {
+			return end();
+		}
+		const size_t height = layers.size();
+		size_t i = 0;
+		for (size_t h = 0; h + 1 < height; ++h) {
+			const size_t c = rank(keys + layers[h].offset + i * B, v);
+			i = std::min(i * (B + 1) + c, layers[h + 1].nodes - 1);
+		}
+		const size_t pos = i * B + rank(keys + layers[height - 1].offset + i * B, v);
+		return begin() + std::min(pos, elements);
+	}
+
+	const_iterator find(const T& v) const {
+		const_iterator it = lower_bound(v);
+		if (it != end() && comp(v, *it)) {
+			return end();
+		}
+		return it;
+	}
+
+	size_type count(const T& v) const {
+		return find(v) != end();
+	}
+
+	bool contains(const T& v) const {
+		return find(v) != end();
+	}
+
+	key_compare key_comp() const {
+		return comp;
+	}
+
+	// The number of layers, leaves included
+	size_type height() const {
+		return layers.size();
+	}
+
+private:
+	struct Layer {
+		size_t offset;
+		size_t nodes;
+		// Leaves under each node
+		size_t span;
+	};
+
+	// How many of the node's keys are less than v
+	size_t rank(const T *node, const T& v) const {
+		size_t c = 0;
+		for (size_t j = 0; j < B; ++j) {
+			c += size_t(comp(node[j], v));
+		}
+		return c;
+	}
+
+	static T *allocate(size_t n) {
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(64)));
+	}
+
+	static void deallocate(T *p) {
+		::operator delete(p, std::align_val_t(64));
+	}
+
+	void release() {
+		if (!keys) {
+			return;
+		}
+		for (size_t i = 0; i < slots; ++i) {
+			keys[i].~T();
+		}
+		deallocate(keys);
+		keys = 0;
+		slots = 0;
+		elements = 0;
+		layers.clear();
+	}
+
+	T *keys;
+	size_t slots;
+	size_t elements;
+	std::vector<Layer> layers;
+	Compare comp;
+};
+
+}
+
+#endif
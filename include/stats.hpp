@@ -0,0 +1,415 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_STATS_HPP
+#define c6d28b7452ec699b_STATS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// Linearly interpolated percentile, p in [0,1], of an already sorted sample
+inline double percentile_sorted(const std::vector<double>& sorted, double p) {
+	if (sorted.empty()) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+	double pos = p * double(sorted.size() - 1);
+	size_t lo = size_t(pos);
+	if (lo + 1 >= sorted.size()) {
+		return sorted.back();
+	}
+	double frac = pos - double(lo);
+	return sorted[lo] + (sorted[lo + 1] - sorted[lo]) * frac;
+}
+
+inline double percentile(std::vector<double> v, double p) {
+	std::sort(v.begin(), v.end());
+	return percentile_sorted(v, p);
+}
+
+inline double median(const std::vector<double>& v) {
+	return percentile(v, 0.5);
+}
+
+inline double mean(const std::vector<double>& v) {
+	if (v.empty()) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+	double sum = 0.0;
+	for (size_t i = 0; i < v.size(); ++i) {
+		sum += v[i];
+	}
+	return sum / double(v.size());
+}
+
+// Sample standard deviation (Bessel corrected)
+inline double stddev(const std::vector<double>& v) {
+	if (v.size() < 2) {
+		return 0.0;
+	}
+	double avg = mean(v);
+	double sum = 0.0;
+	for (size_t i = 0; i < v.size(); ++i) {
+		sum += (v[i] - avg) * (v[i] - avg);
+	}
+	return std::sqrt(sum / double(v.size() - 1));
+}
+
+// Median absolute deviation, scaled by 1.4826 so it estimates the standard
+// deviation for normally distributed samples
+inline double mad(const std::vector<double>& v) {
+	if (v.empty()) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+	double med = median(v);
+	std::vector<double> dev(v.size());
+	for (size_t i = 0; i < v.size(); ++i) {
+		dev[i] = std::fabs(v[i] - med);
+	}
+	return 1.4826 * median(dev);
+}
+
+// Drops samples further than k scaled MADs from the median. If the MAD is 0
+// (more than half the samples are identical) nothing is dropped.
+inline std::vector<double> reject_outliers(const std::vector<double>& v, double k) {
+	double m = mad(v);
+	if (!(k > 0.0) || !(m > 0.0)) {
+		return v;
+	}
+	double med = median(v);
+	std::vector<double> rv;
+	rv.reserve(v.size());
+	for (size_t i = 0; i < v.size(); ++i) {
+		if (std::fabs(v[i] - med) <= k * m) {
+			rv.push_back(v[i]);
+		}
+	}
+	return rv;
+}
+
+// Percentile bootstrap confidence interval of the median. Uses a fixed seed so
+// the same samples always yield the same interval.
+inline std::pair<double, double> bootstrap_ci(const std::vector<double>& v, double confidence = 0.95, size_t resamples = 1000, uint64_t seed = 902200987) {
+	if (v.size() < 2) {
+		double d = v.empty() ? std::numeric_limits<double>::quiet_NaN() : v.front();
+		return std::make_pair(d, d);
+	}
+	std::mt19937_64 rng(seed);
+	std::uniform_int_distribution<size_t> pick(0, v.size() - 1);
+	std::vector<double> sample(v.size());
+	std::vector<double> medians(resamples);
+	for (size_t r = 0; r < resamples; ++r) {
+		for (size_t i = 0; i < sample.size(); ++i) {
+			sample[i] = v[pick(rng)];
+		}
+		std::sort(sample.begin(), sample.end());
+		medians[r] = percentile_sorted(sample, 0.5);
+	}
+	std::sort(medians.begin(), medians.end());
+	double alpha = (1.0 - confidence) / 2.0;
+	return std::make_pair(percentile_sorted(medians, alpha), percentile_sorted(medians, 1.0 - alpha));
+}
+
+struct Summary {
+	size_t count;
+	size_t outliers;
+	double min;
+	double p5;
+	double median;
+	double mean;
+	double stddev;
+	double p95;
+	double mad;
+	double ci_lo;
+	double ci_hi;
+
+	// Width of the confidence interval relative to the median, in percent
+	double ci_width() const {
+		return (ci_hi - ci_lo) / median * 100.0;
+	}
+};
+
+// Summarizes a sample, first dropping outliers beyond reject_k scaled MADs if
+// reject_k is positive
+inline Summary summarize(const std::vector<double>& raw, double reject_k = 0.0) {
+	std::vector<double> v = reject_outliers(raw, reject_k);
+	std::sort(v.begin(), v.end());
+	Summary s;
+	s.count = v.size();
+	s.outliers = raw.size() - v.size();
+	s.min = v.empty() ? std::numeric_limits<double>::quiet_NaN() : v.front();
+	s.p5 = percentile_sorted(v, 0.05);
+	s.median = percentile_sorted(v, 0.5);
+	s.mean = bench::mean(v);
+	s.stddev = bench::stddev(v);
+	s.p95 = percentile_sorted(v, 0.95);
+	s.mad = bench::mad(v);
+	std::pair<double, double> ci = bootstrap_ci(v);
+	s.ci_lo = ci.first;
+	s.ci_hi = ci.second;
+	return s;
+}
+
+// Regularized incomplete beta function I_x(a, b), via Lentz's continued fraction
+inline double incomplete_beta(double a, double b, double x) {
+	if (x <= 0.0) {
+		return 0.0;
+	}
+	if (x >= 1.0) {
+		return 1.0;
+	}
+	if (x > (a + 1.0) / (a + b + 2.0)) {
+		return 1.0 - incomplete_beta(b, a, 1.0 - x);
+	}
+	const double tiny = 1e-300;
+	double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1.0 - x)) / a;
+	double c = 1.0;
+	double d = 1.0 - (a + b) * x / (a + 1.0);
+	if (std::fabs(d) < tiny) {
+		d = tiny;
+	}
+	d = 1.0 / d;
+	double f = d;
+	for (int m = 1; m <= 300; ++m) {
+		for (int odd = 0; odd < 2; ++odd) {
+			double num = 0.0;
+			if (odd == 0) {
+				num = m * (b - m) * x / ((a + 2.0 * m - 1.0) * (a + 2.0 * m));
+			}
+			else {
+				num = -(a + m) * (a + b + m) * x / ((a + 2.0 * m) * (a + 2.0 * m + 1.0));
+			}
+			d = 1.0 + num * d;
+			if (std::fabs(d) < tiny) {
+				d = tiny;
+			}
+			c = 1.0 + num / c;
+			if (std::fabs(c) < tiny) {
+				c = tiny;
+			}
+			d = 1.0 / d;
+			f *= c * d;
+		}
+		if (std::fabs(c * d - 1.0) < 1e-12) {
+			break;
+		}
+	}
+	return front * f;
+}
+
+// Log-linear histogram for latencies: values below 16 are kept exactly,
+// larger ones in 16 linear sub-buckets per power of two, so percentiles are
+// within about 6% of the true value at constant memory
+class Histogram {
+public:
+	Histogram() : counts(61 * 16, 0), total(0), largest(0) {
+	}
+
+	void add(double v) {
+		uint64_t u = (v > 0.0) ? uint64_t(v) : 0;
+		++counts[bucket(u)];
+		++total;
+		if (u > largest) {
+			largest = u;
+		}
+	}
+
+	// Adds all of another histogram's values, e.g. one per thread
+	void merge(const Histogram& o) {
+		for (size_t b = 0; b < counts.size(); ++b) {
+			counts[b] += o.counts[b];
+		}
+		total += o.total;
+		largest = std::max(largest, o.largest);
+	}
+
+	size_t count() const {
+		return total;
+	}
+
+	double max() const {
+		return double(largest);
+	}
+
+	// Midpoint of the bucket holding the p-th value, p in [0,1]
+	double percentile(double p) const {
+		if (total == 0) {
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+		size_t rank = size_t(std::ceil(p * double(total)));
+		if (rank == 0) {
+			rank = 1;
+		}
+		size_t seen = 0;
+		for (size_t b = 0; b < counts.size(); ++b) {
+			seen += counts[b];
+			if (seen >= rank) {
+				double mid = (lower(b) + lower(b + 1) - 1.0) / 2.0;
+				return std::min(mid, double(largest));
+			}
+		}
+		return double(largest);
+	}
+
+private:
+	std::vector<size_t> counts;
+	size_t total;
+	uint64_t largest;
+
+	static size_t bucket(uint64_t v) {
+		if (v < 16) {
+			return size_t(v);
+		}
+		unsigned e = 4;
+		while (e < 63 && (v >> (e + 1))) {
+			++e;
+		}
+		return (e - 3) * 16 + size_t((v >> (e - 4)) & 15);
+	}
+
+	static double lower(size_t b) {
+		if (b < 16) {
+			return double(b);
+		}
+		unsigned e = unsigned(b / 16) + 3;
+		return std::ldexp(double(16 + b % 16), int(e) - 4);
+	}
+};
+
+struct TestResult {
+	double statistic;
+	double p;
+};
+
+// Welch's unequal variances t-test, two-sided
+inline TestResult welch_t_test(const std::vector<double>& a, const std::vector<double>& b) {
+	TestResult rv = { 0.0, 1.0 };
+	if (a.size() < 2 || b.size() < 2) {
+		return rv;
+	}
+	double va = stddev(a) * stddev(a) / double(a.size());
+	double vb = stddev(b) * stddev(b) / double(b.size());
+	if (!(va + vb > 0.0)) {
+		rv.p = (mean(a) == mean(b)) ? 1.0 : 0.0;
+		return rv;
+	}
+	double t = (mean(a) - mean(b)) / std::sqrt(va + vb);
+	double df = (va + vb) * (va + vb) / (va * va / double(a.size() - 1) + vb * vb / double(b.size() - 1));
+	rv.statistic = t;
+	rv.p = incomplete_beta(df / 2.0, 0.5, df / (df + t * t));
+	return rv;
+}
+
+// Mann-Whitney U test, two-sided. Exact for small samples without ties,
+// otherwise the tie corrected normal approximation with continuity correction.
+inline TestResult mann_whitney_u(const std::vector<double>& a, const std::vector<double>& b) {
+	TestResult rv = { 0.0, 1.0 };
+	size_t n1 = a.size(), n2 = b.size();
+	if (n1 == 0 || n2 == 0) {
+		return rv;
+	}
+
+	std::vector< std::pair<double, size_t> > all;
+	for (size_t i = 0; i < n1; ++i) {
+		all.push_back(std::make_pair(a[i], 0));
+	}
+	for (size_t i = 0; i < n2; ++i) {
+		all.push_back(std::make_pair(b[i], 1));
+	}
+	std::sort(all.begin(), all.end());
+
+	double rank_a = 0.0;
+	double ties = 0.0;
+	for (size_t i = 0; i < all.size();) {
+		size_t j = i;
+		while (j < all.size() && all[j].first == all[i].first) {
+			++j;
+		}
+		double rank = (double(i + 1) + double(j)) / 2.0;
+		for (size_t k = i; k < j; ++k) {
+			if (all[k].second == 0) {
+				rank_a += rank;
+			}
+		}
+		double t = double(j - i);
+		ties += t * t * t - t;
+		i = j;
+	}
+
+	double u = rank_a - double(n1) * double(n1 + 1) / 2.0;
+	double mu = double(n1) * double(n2) / 2.0;
+	rv.statistic = u;
+
+	if (ties == 0.0 && n1 + n2 <= 40) {
+		size_t umax = n1 * n2;
+		// f(i, j, k): ways to arrange i a-values and j b-values with U == k
+		std::vector< std::vector< std::vector<double> > > f(n1 + 1, std::vector< std::vector<double> >(n2 + 1, std::vector<double>(umax + 1, 0.0)));
+		for (size_t i = 0; i <= n1; ++i) {
+			for (size_t j = 0; j <= n2; ++j) {
+				for (size_t k = 0; k <= i * j; ++k) {
+					if (i == 0 || j == 0) {
+						f[i][j][k] = (k == 0) ? 1.0 : 0.0;
+						continue;
+					}
+					// Largest value is either an a (it beats all j b-values) or a b
+					double w = 0.0;
+					if (k >= j) {
+						w += f[i - 1][j][k - j];
+					}
+					w += f[i][j - 1][k];
+					f[i][j][k] = w;
+				}
+			}
+		}
+		double total = 0.0;
+		for (size_t k = 0; k <= umax; ++k) {
+			total += f[n1][n2][k];
+		}
+		double lo = std::min(u, double(umax) - u);
+		double tail = 0.0;
+		for (size_t k = 0; double(k) <= lo; ++k) {
+			tail += f[n1][n2][k];
+		}
+		rv.p = std::min(1.0, 2.0 * tail / total);
+		return rv;
+	}
+
+	double n = double(n1 + n2);
+	double sigma = std::sqrt(double(n1) * double(n2) / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0))));
+	if (!(sigma > 0.0)) {
+		return rv;
+	}
+	double z = (std::fabs(u - mu) - 0.5) / sigma;
+	if (z < 0.0) {
+		z = 0.0;
+	}
+	rv.p = std::erfc(z / std::sqrt(2.0));
+	return rv;
+}
+
+}
+
+#endif
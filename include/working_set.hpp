@@ -0,0 +1,145 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_WORKING_SET_HPP
+#define c6d28b7452ec699b_WORKING_SET_HPP
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __GLIBC__
+	#include <malloc.h>
+#endif
+
+/*
+ * Where a working set lives: the data cache geometry from sysfs, the heap in
+ * use as seen by malloc, and the classification of a footprint as L1, L2,
+ * LLC or DRAM resident.
+ */
+namespace bench {
+
+// Bytes currently allocated from the heap, or 0 if that can't be determined
+inline size_t heap_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	struct mallinfo2 mi = mallinfo2();
+	return mi.uordblks + mi.hblkhd;
+#elif defined(__GLIBC__)
+	struct mallinfo mi = mallinfo();
+	return size_t(unsigned(mi.uordblks)) + size_t(unsigned(mi.hblkhd));
+#else
+	return 0;
+#endif
+}
+
+inline std::string format_bytes(size_t bytes) {
+	const char *units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+	double d = double(bytes);
+	size_t u = 0;
+	while (d >= 1024.0 && u < 4) {
+		d /= 1024.0;
+		++u;
+	}
+	char buf[32];
+	snprintf(buf, sizeof(buf), u ? "%.1f %s" : "%.0f %s", d, units[u]);
+	return buf;
+}
+
+struct CacheLevel {
+	unsigned level;
+	// Data or Unified; instruction caches are skipped
+	std::string type;
+	size_t size;
+	size_t line;
+};
+
+struct CacheInfo {
+	// Data and unified caches, innermost first
+	std::vector<CacheLevel> levels;
+
+	static CacheInfo detect(int cpu = 0) {
+		CacheInfo ci;
+		std::ostringstream base;
+		base << "/sys/devices/system/cpu/cpu" << (cpu >= 0 ? cpu : 0) << "/cache/index";
+		for (size_t i = 0; i < 16; ++i) {
+			std::ostringstream dir;
+			dir << base.str() << i << "/";
+			CacheLevel cl;
+			std::string level, size, line;
+			std::ifstream(dir.str() + "level") >> level;
+			std::ifstream(dir.str() + "type") >> cl.type;
+			std::ifstream(dir.str() + "size") >> size;
+			std::ifstream(dir.str() + "coherency_line_size") >> line;
+			if (level.empty()) {
+				break;
+			}
+			if (cl.type == "Instruction" || size.empty()) {
+				continue;
+			}
+			cl.level = unsigned(std::strtoul(level.c_str(), 0, 10));
+			char *end = 0;
+			cl.size = std::strtoull(size.c_str(), &end, 10);
+			if (*end == 'K') {
+				cl.size *= 1024;
+			}
+			else if (*end == 'M') {
+				cl.size *= 1024 * 1024;
+			}
+			cl.line = std::strtoull(line.c_str(), 0, 10);
+			ci.levels.push_back(cl);
+		}
+		return ci;
+	}
+
+	// The innermost cache the footprint fits in: L1, L2, LLC or DRAM.
+	// Empty if the footprint or the geometry is unknown.
+	std::string residency(size_t bytes) const {
+		if (bytes == 0 || levels.empty()) {
+			return "";
+		}
+		for (size_t i = 0; i < levels.size(); ++i) {
+			if (bytes <= levels[i].size) {
+				if (i + 1 == levels.size() && levels[i].level > 1) {
+					return "LLC";
+				}
+				return "L" + std::to_string(levels[i].level);
+			}
+		}
+		return "DRAM";
+	}
+
+	// E.g. "L1 48.0 KiB, L2 2.0 MiB, L3 105.0 MiB"
+	std::string describe() const {
+		std::string rv;
+		for (size_t i = 0; i < levels.size(); ++i) {
+			if (i) {
+				rv += ", ";
+			}
+			rv += "L" + std::to_string(levels[i].level) + " " + format_bytes(levels[i].size);
+		}
+		return rv;
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,413 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef c6d28b7452ec699b_WORKLOADS_HPP
+#define c6d28b7452ec699b_WORKLOADS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Key generators for the container benchmarks. A distribution is named on the
+ * command line as NAME or NAME:ARG:
+ *
+ *	dense           uniform over [0, n) rounded up to a power of two (default)
+ *	uniform         uniform over the full range of the key type
+ *	zipf[:S]        n distinct keys with Zipf skew S in (0,1), default 0.99
+ *	sequential[:G]  ascending, each key 1..G above the previous, default G=1
+ *	clustered[:L]   runs of L consecutive keys from random starts, default 64
+ *	adversarial     distinct keys that all share their low bits
+ *
+ * The adversarial keys only collide in hash tables that use the identity hash
+ * and a power of two bucket count. libstdc++'s std::unordered_set uses prime
+ * bucket counts, and the string keys are decimal forms hashed as strings, so
+ * for those they behave about like uniform keys.
+ *
+ * All generators are seeded, so a given distribution and n always yields the
+ * same keys. The dense keys are the ones set.cpp drew before there was a
+ * choice of distribution.
+ *
+ * OpMix describes an interleaved operation trace over such a key set, e.g.
+ * lookup:90,insert:8,erase:2,skew:0.99 (see OpMix::trace()).
+ */
+namespace bench {
+
+// splitmix64 finalizer, used to scatter ranks over the key space
+inline uint64_t mix64(uint64_t x) {
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+}
+
+// Zipf distributed ranks in [0, n), rank 0 most popular, after Gray et al.
+// "Quickly generating billion-record synthetic databases" as used by YCSB
+class Zipf {
+public:
+	Zipf(uint64_t n, double theta) : n(n), theta(theta) {
+		if (!(theta > 0.0 && theta < 1.0) || n == 0) {
+			throw std::invalid_argument("Zipf skew must be in (0,1)");
+		}
+		zetan = zeta(n, theta);
+		double zeta2 = zeta(2, theta);
+		alpha = 1.0 / (1.0 - theta);
+		eta = (1.0 - std::pow(2.0 / double(n), 1.0 - theta)) / (1.0 - zeta2 / zetan);
+		half_pow = 1.0 + std::pow(0.5, theta);
+	}
+
+	template<typename RNG>
+	uint64_t operator()(RNG& rng) {
+		double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+		double uz = u * zetan;
+		if (uz < 1.0) {
+			return 0;
+		}
+		if (uz < half_pow) {
+			return 1;
+		}
+		uint64_t r = uint64_t(double(n) * std::pow(eta * u - eta + 1.0, alpha));
+		return std::min(r, n - 1);
+	}
+
+private:
+	uint64_t n;
+	double theta;
+	double zetan;
+	double alpha;
+	double eta;
+	double half_pow;
+
+	static double zeta(uint64_t n, double theta) {
+		double sum = 0.0;
+		for (uint64_t i = 1; i <= n; ++i) {
+			sum += 1.0 / std::pow(double(i), theta);
+		}
+		return sum;
+	}
+};
+
+struct KeyDistribution {
+	std::string name;
+	double arg;
+
+	KeyDistribution() : name("dense"), arg(0.0) {
+	}
+
+	// Parses NAME or NAME:ARG; throws std::invalid_argument
+	static KeyDistribution parse(const std::string& spec) {
+		KeyDistribution kd;
+		size_t colon = spec.find(':');
+		kd.name = spec.substr(0, colon);
+		if (kd.name == "zipf") {
+			kd.arg = 0.99;
+		}
+		else if (kd.name == "sequential") {
+			kd.arg = 1;
+		}
+		else if (kd.name == "clustered") {
+			kd.arg = 64;
+		}
+		else if (kd.name != "dense" && kd.name != "uniform" && kd.name != "adversarial") {
+			throw std::invalid_argument("unknown key distribution: " + kd.name);
+		}
+		if (colon != std::string::npos) {
+			char *end = 0;
+			kd.arg = std::strtod(spec.c_str() + colon + 1, &end);
+			if (*end || !(kd.arg > 0.0) || (kd.name == "zipf" && kd.arg >= 1.0)) {
+				throw std::invalid_argument("invalid key distribution argument: " + spec);
+			}
+		}
+		return kd;
+	}
+
+	// Parses a comma separated list of distributions
+	static std::vector<KeyDistribution> parse_list(const std::string& specs) {
+		std::vector<KeyDistribution> rv;
+		std::istringstream ss(specs);
+		std::string spec;
+		while (std::getline(ss, spec, ',')) {
+			rv.push_back(parse(spec));
+		}
+		return rv;
+	}
+
+	std::string str() const {
+		if (name == "dense" || name == "uniform" || name == "adversarial") {
+			return name;
+		}
+		std::ostringstream ss;
+		ss << name << ":" << arg;
+		return ss.str();
+	}
+
+	// n keys of type T, in insertion order
+	template<typename T>
+	std::vector<T> generate(size_t n, uint64_t seed = 902200987) const {
+		const unsigned bits = std::numeric_limits<T>::digits;
+		const uint64_t tmax = std::numeric_limits<T>::max();
+		std::mt19937_64 rng(seed);
+		std::vector<T> rv;
+		rv.reserve(n);
+
+		if (name == "dense") {
+			// From a 32 bit mt19937 like before, so that results recorded
+			// under the default kernel names stay comparable
+			std::mt19937 rng32(static_cast<uint32_t>(seed));
+			uint64_t mask = 1;
+			while (mask < n && mask <= (tmax >> 1)) {
+				mask <<= 1;
+			}
+			--mask;
+			for (size_t i = 0; i < n; ++i) {
+				uint64_t r = rng32();
+				if (mask > 0xFFFFFFFFull) {
+					r |= uint64_t(rng32()) << 32;
+				}
+				rv.push_back(T(r & mask));
+			}
+		}
+		else if (name == "uniform") {
+			for (size_t i = 0; i < n; ++i) {
+				rv.push_back(T(rng()));
+			}
+		}
+		else if (name == "zipf") {
+			Zipf zipf(n, arg);
+			for (size_t i = 0; i < n; ++i) {
+				rv.push_back(T(mix64(zipf(rng))));
+			}
+		}
+		else if (name == "sequential") {
+			uint64_t gap = uint64_t(arg);
+			uint64_t key = 0;
+			for (size_t i = 0; i < n; ++i) {
+				rv.push_back(T(key));
+				key += 1 + (gap > 1 ? rng() % gap : 0);
+			}
+		}
+		else if (name == "clustered") {
+			size_t run = std::max<size_t>(1, size_t(arg));
+			uint64_t key = 0;
+			for (size_t i = 0; i < n; ++i) {
+				if (i % run == 0) {
+					key = rng() & tmax;
+				}
+				rv.push_back(T(key));
+				++key;
+			}
+		}
+		else if (name == "adversarial") {
+			// Distinct counters rotated by half the key width, so the low half
+			// is the same for the first 2^(bits/2) keys and identity hashes
+			// masked to a power of two bucket count all land in one bucket;
+			// prime bucket counts and string hashes spread them out as usual
+			const unsigned half = bits / 2;
+			for (size_t i = 0; i < n; ++i) {
+				uint64_t k = uint64_t(i) & tmax;
+				rv.push_back(T(((k << half) | (k >> (bits - half))) & tmax));
+			}
+			std::shuffle(rv.begin(), rv.end(), rng);
+		}
+		return rv;
+	}
+
+	// n keys that are not in present. They are drawn from this distribution
+	// while it still yields new keys, otherwise (e.g. sequential, where every
+	// seed gives the same keys) uniformly from the whole key type. Returns
+	// fewer than n only if the key type is nearly exhausted.
+	template<typename T>
+	std::vector<T> absent(const std::vector<T>& present, size_t n, uint64_t seed = 1549556379) const {
+		std::vector<T> sorted(present);
+		std::sort(sorted.begin(), sorted.end());
+		sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+		KeyDistribution uniform;
+		uniform.name = "uniform";
+		const KeyDistribution *from = this;
+		std::vector<T> rv;
+		rv.reserve(n);
+		for (size_t attempt = 0; rv.size() < n && attempt < 64; ++attempt) {
+			size_t before = rv.size();
+			std::vector<T> candidates = from->generate<T>(n, seed + attempt);
+			for (size_t i = 0; i < candidates.size() && rv.size() < n; ++i) {
+				if (!std::binary_search(sorted.begin(), sorted.end(), candidates[i])) {
+					rv.push_back(candidates[i]);
+				}
+			}
+			if (rv.size() - before < n / 100 + 1) {
+				from = &uniform;
+			}
+		}
+		return rv;
+	}
+};
+
+// n lookups where each is a random one of hits with probability hit_ratio,
+// otherwise a random one of misses
+template<typename T>
+inline std::vector<T> mix_queries(const std::vector<T>& hits, const std::vector<T>& misses, double hit_ratio, size_t n, uint64_t seed = 902200987) {
+	std::mt19937_64 rng(seed);
+	std::uniform_real_distribution<double> coin(0.0, 1.0);
+	std::vector<T> rv;
+	rv.reserve(n);
+	for (size_t i = 0; i < n; ++i) {
+		const std::vector<T>& from = (coin(rng) < hit_ratio || misses.empty()) ? hits : misses;
+		if (from.empty()) {
+			break;
+		}
+		rv.push_back(from[rng() % from.size()]);
+	}
+	return rv;
+}
+
+// n half-open windows [lo, hi) over the sorted distinct keys that each hold
+// exactly span of them, starting at uniformly random keys. Every hi is a real
+// key, so there are none unless span is at least 1 and below the number of
+// distinct keys.
+template<typename T>
+inline std::vector< std::pair<T, T> > range_windows(const std::vector<T>& keys, size_t span, size_t n, uint64_t seed = 902200987) {
+	std::vector<T> sorted(keys);
+	std::sort(sorted.begin(), sorted.end());
+	sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+	std::vector< std::pair<T, T> > rv;
+	if (span == 0 || span >= sorted.size()) {
+		return rv;
+	}
+	std::mt19937_64 rng(seed);
+	rv.reserve(n);
+	for (size_t i = 0; i < n; ++i) {
+		size_t lo = size_t(rng() % (sorted.size() - span));
+		rv.push_back(std::make_pair(sorted[lo], sorted[lo + span]));
+	}
+	return rv;
+}
+
+enum {
+	OP_LOOKUP,
+	OP_INSERT,
+	OP_ERASE,
+	OP_TYPES,
+};
+
+inline const char *op_name(size_t type) {
+	static const char *names[OP_TYPES] = { "lookup", "insert", "erase" };
+	return names[type];
+}
+
+// One step of an operation trace; key indexes the benchmark's key vector
+struct Op {
+	uint32_t key;
+	uint32_t type;
+};
+
+struct OpMix {
+	// Relative weights, need not sum to 100
+	double weights[OP_TYPES];
+	// Zipf skew of the keys lookups and erases pick; 0 picks uniformly
+	double skew;
+
+	OpMix() : skew(0.99) {
+		weights[OP_LOOKUP] = 90;
+		weights[OP_INSERT] = 8;
+		weights[OP_ERASE] = 2;
+	}
+
+	// Parses e.g. lookup:90,insert:8,erase:2,skew:0.99; unnamed operations
+	// get weight 0. Throws std::invalid_argument.
+	static OpMix parse(const std::string& spec) {
+		OpMix mix;
+		std::fill(mix.weights, mix.weights + OP_TYPES, 0.0);
+		std::istringstream ss(spec);
+		std::string item;
+		while (std::getline(ss, item, ',')) {
+			size_t colon = item.find(':');
+			if (colon == std::string::npos) {
+				throw std::invalid_argument("invalid operation mix item: " + item);
+			}
+			std::string name = item.substr(0, colon);
+			double value = std::strtod(item.c_str() + colon + 1, 0);
+			if (name == "skew") {
+				mix.skew = value;
+				continue;
+			}
+			size_t t = 0;
+			while (t < OP_TYPES && name != op_name(t)) {
+				++t;
+			}
+			if (t == OP_TYPES || value < 0.0) {
+				throw std::invalid_argument("invalid operation mix item: " + item);
+			}
+			mix.weights[t] = value;
+		}
+		if (!(mix.weights[OP_LOOKUP] + mix.weights[OP_INSERT] + mix.weights[OP_ERASE] > 0.0) || mix.skew < 0.0 || mix.skew >= 1.0) {
+			throw std::invalid_argument("invalid operation mix: " + spec);
+		}
+		return mix;
+	}
+
+	std::string str() const {
+		std::ostringstream ss;
+		for (size_t t = 0; t < OP_TYPES; ++t) {
+			ss << op_name(t) << ":" << weights[t] << ",";
+		}
+		ss << "skew:" << skew;
+		return ss.str();
+	}
+
+	// A trace of ops operations over keys keys. Lookups and erases pick keys
+	// with the configured skew, so a few keys are hot; inserts pick uniformly,
+	// so they add new keys as often as the key set allows. The hottest keys
+	// are the first ones in the key vector.
+	std::vector<Op> trace(size_t keys, size_t ops, uint64_t seed = 902200987) const {
+		std::mt19937_64 rng(seed);
+		std::discrete_distribution<uint32_t> pick_op(weights, weights + OP_TYPES);
+		std::uniform_int_distribution<uint64_t> uniform(0, keys ? keys - 1 : 0);
+		std::vector<Op> rv(ops);
+		if (skew > 0.0 && keys > 0) {
+			Zipf zipf(keys, skew);
+			for (size_t i = 0; i < ops; ++i) {
+				rv[i].type = pick_op(rng);
+				rv[i].key = uint32_t(rv[i].type == OP_INSERT ? uniform(rng) : zipf(rng));
+			}
+		}
+		else {
+			for (size_t i = 0; i < ops; ++i) {
+				rv[i].type = pick_op(rng);
+				rv[i].key = uint32_t(uniform(rng));
+			}
+		}
+		return rv;
+	}
+};
+
+}
+
+#endif
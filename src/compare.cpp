@@ -0,0 +1,407 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Compares two result files written with --json, e.g. before and after a
+ * compiler or library upgrade, and reports per variant speedups with a
+ * significance test on the raw samples.
+ *
+ *	compare [--threshold PCT] [--alpha A] [--test mwu|welch] old.json new.json
+ *
+ * Exits with 2 if any variant regressed by more than the threshold with
+ * p < alpha, so it can gate a CI job.
+ *
+ * When both files carry a calibrated tick rate the samples are compared in
+ * ns, so results from different hosts can be compared; otherwise in ticks.
+ */
+
+#include <stats.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Just enough of a JSON reader for the flat records bench::ResultWriter emits
+struct Record {
+	std::string benchmark;
+	std::string variant;
+	std::string phase;
+	size_t n;
+	double ns_per_tick;
+	std::vector<double> samples;
+};
+
+class RecordParser {
+public:
+	RecordParser(const std::string& line) : s(line), p(0) {
+	}
+
+	bool parse(Record& rec) {
+		rec.n = 0;
+		rec.ns_per_tick = std::numeric_limits<double>::quiet_NaN();
+		try {
+			ws();
+			expect('{');
+			ws();
+			if (peek() == '}') {
+				return true;
+			}
+			for (;;) {
+				ws();
+				std::string key = string();
+				ws();
+				expect(':');
+				ws();
+				if (key == "benchmark") {
+					rec.benchmark = string();
+				}
+				else if (key == "variant") {
+					rec.variant = string();
+				}
+				else if (key == "phase") {
+					rec.phase = string();
+				}
+				else if (key == "n") {
+					rec.n = size_t(number());
+				}
+				else if (key == "host") {
+					expect('{');
+					ws();
+					while (peek() != '}') {
+						std::string hkey = string();
+						ws();
+						expect(':');
+						ws();
+						if (hkey == "ns_per_tick") {
+							rec.ns_per_tick = number();
+						}
+						else {
+							skip();
+						}
+						ws();
+						if (peek() == ',') {
+							++p;
+							ws();
+						}
+					}
+					++p;
+				}
+				else if (key == "samples") {
+					expect('[');
+					ws();
+					while (peek() != ']') {
+						rec.samples.push_back(number());
+						ws();
+						if (peek() == ',') {
+							++p;
+							ws();
+						}
+					}
+					++p;
+				}
+				else {
+					skip();
+				}
+				ws();
+				if (peek() == ',') {
+					++p;
+					continue;
+				}
+				expect('}');
+				break;
+			}
+		}
+		catch (const std::exception&) {
+			return false;
+		}
+		return true;
+	}
+
+private:
+	const std::string& s;
+	size_t p;
+
+	char peek() const {
+		if (p >= s.size()) {
+			throw std::runtime_error("unexpected end of line");
+		}
+		return s[p];
+	}
+
+	void ws() {
+		while (p < s.size() && (s[p] == ' ' || s[p] == '\t' || s[p] == '\r' || s[p] == '\n')) {
+			++p;
+		}
+	}
+
+	void expect(char c) {
+		if (peek() != c) {
+			throw std::runtime_error(std::string("expected ") + c);
+		}
+		++p;
+	}
+
+	std::string string() {
+		expect('"');
+		std::string rv;
+		while (peek() != '"') {
+			char c = s[p++];
+			if (c == '\\') {
+				c = peek();
+				++p;
+				if (c == 'u') {
+					unsigned cp = std::strtoul(s.substr(p, 4).c_str(), 0, 16);
+					p += 4;
+					c = char(cp);
+				}
+				else if (c == 'n') {
+					c = '\n';
+				}
+				else if (c == 't') {
+					c = '\t';
+				}
+			}
+			rv += c;
+		}
+		++p;
+		return rv;
+	}
+
+	double number() {
+		if (s.compare(p, 4, "null") == 0) {
+			p += 4;
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+		const char *b = s.c_str() + p;
+		char *e = 0;
+		double d = std::strtod(b, &e);
+		if (e == b) {
+			throw std::runtime_error("expected number");
+		}
+		p += e - b;
+		return d;
+	}
+
+	// Skips any value
+	void skip() {
+		char c = peek();
+		if (c == '"') {
+			string();
+		}
+		else if (c == '{' || c == '[') {
+			char close = (c == '{') ? '}' : ']';
+			++p;
+			ws();
+			while (peek() != close) {
+				if (c == '{') {
+					string();
+					ws();
+					expect(':');
+					ws();
+				}
+				skip();
+				ws();
+				if (peek() == ',') {
+					++p;
+					ws();
+				}
+			}
+			++p;
+		}
+		else if (s.compare(p, 4, "true") == 0 || s.compare(p, 4, "null") == 0) {
+			p += 4;
+		}
+		else if (s.compare(p, 5, "false") == 0) {
+			p += 5;
+		}
+		else {
+			number();
+		}
+	}
+};
+
+typedef std::map<std::string, Record> Records;
+
+std::string keyOf(const Record& r) {
+	std::ostringstream ss;
+	ss << r.benchmark << "\t" << r.variant << "\t" << r.phase << "\t" << r.n;
+	return ss.str();
+}
+
+// Records with the same benchmark/variant/phase/n are merged, so repeated runs
+// appended to one file pool their samples
+bool readRecords(const char *fname, Records& recs, std::vector<std::string>& order) {
+	std::ifstream in(fname, std::ios::binary);
+	if (!in) {
+		std::cerr << "Could not open " << fname << std::endl;
+		return false;
+	}
+	std::string line;
+	size_t lineno = 0;
+	while (std::getline(in, line)) {
+		++lineno;
+		if (line.find_first_not_of(" \t\r") == std::string::npos) {
+			continue;
+		}
+		Record rec;
+		RecordParser parser(line);
+		if (!parser.parse(rec)) {
+			std::cerr << fname << ":" << lineno << ": could not parse record, skipping" << std::endl;
+			continue;
+		}
+		std::string key = keyOf(rec);
+		Records::iterator it = recs.find(key);
+		if (it == recs.end()) {
+			recs[key] = rec;
+			order.push_back(key);
+		}
+		else {
+			it->second.samples.insert(it->second.samples.end(), rec.samples.begin(), rec.samples.end());
+		}
+	}
+	return true;
+}
+
+void usage(const char *self) {
+	std::cerr << "Usage: " << self << " [options] old.json new.json\n";
+	std::cerr << " --threshold PCT   flag slowdowns larger than PCT percent (default 5)\n";
+	std::cerr << " --alpha A         significance level (default 0.05)\n";
+	std::cerr << " --test mwu|welch  Mann-Whitney U (default) or Welch's t-test\n";
+}
+
+int main(int argc, char *argv[]) {
+	double threshold = 5.0;
+	double alpha = 0.05;
+	bool welch = false;
+	std::vector<const char*> files;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--threshold" && i + 1 < argc) {
+			threshold = std::strtod(argv[++i], 0);
+		}
+		else if (arg == "--alpha" && i + 1 < argc) {
+			alpha = std::strtod(argv[++i], 0);
+		}
+		else if (arg == "--test" && i + 1 < argc) {
+			std::string t = argv[++i];
+			if (t != "mwu" && t != "welch") {
+				usage(argv[0]);
+				return 1;
+			}
+			welch = (t == "welch");
+		}
+		else if (arg.size() > 1 && arg[0] == '-') {
+			usage(argv[0]);
+			return (arg == "-h" || arg == "--help") ? 0 : 1;
+		}
+		else {
+			files.push_back(argv[i]);
+		}
+	}
+	if (files.size() != 2) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	Records olds, news;
+	std::vector<std::string> old_order, new_order;
+	if (!readRecords(files[0], olds, old_order) || !readRecords(files[1], news, new_order)) {
+		return 1;
+	}
+
+	size_t regressions = 0, improvements = 0, missing = 0;
+	std::cout << std::fixed;
+	std::cout << "benchmark\tvariant\tphase\tn\told median\tnew median\tunit\tspeedup\tp\tverdict" << std::endl;
+	for (size_t i = 0; i < new_order.size(); ++i) {
+		const Record& nr = news[new_order[i]];
+		Records::const_iterator it = olds.find(new_order[i]);
+		if (it == olds.end()) {
+			++missing;
+			continue;
+		}
+		if (it->second.samples.empty() || nr.samples.empty()) {
+			continue;
+		}
+
+		std::vector<double> os = it->second.samples, ns = nr.samples;
+		const char *unit = "ticks";
+		if (std::isfinite(it->second.ns_per_tick) && std::isfinite(nr.ns_per_tick)) {
+			for (size_t k = 0; k < os.size(); ++k) {
+				os[k] *= it->second.ns_per_tick;
+			}
+			for (size_t k = 0; k < ns.size(); ++k) {
+				ns[k] *= nr.ns_per_tick;
+			}
+			unit = "ns";
+		}
+
+		double om = bench::median(os);
+		double nm = bench::median(ns);
+		double speedup = om / nm;
+		bench::TestResult test = welch ? bench::welch_t_test(os, ns) : bench::mann_whitney_u(os, ns);
+		double change = (nm - om) / om * 100.0;
+
+		const char *verdict = "same";
+		if (test.p < alpha) {
+			if (change > threshold) {
+				verdict = "REGRESSION";
+				++regressions;
+			}
+			else if (change < -threshold) {
+				verdict = "improved";
+				++improvements;
+			}
+			else if (change > 0.0) {
+				verdict = "slower";
+			}
+			else {
+				verdict = "faster";
+			}
+		}
+
+		std::cout << nr.benchmark << "\t" << nr.variant << "\t" << nr.phase << "\t" << nr.n;
+		std::cout << std::setprecision(0) << "\t" << om << "\t" << nm << "\t" << unit;
+		std::cout << std::setprecision(3) << "\t" << speedup << "\t" << std::setprecision(4) << test.p;
+		std::cout << "\t" << verdict << std::endl;
+	}
+	for (size_t i = 0; i < old_order.size(); ++i) {
+		if (news.find(old_order[i]) == news.end()) {
+			++missing;
+		}
+	}
+
+	std::cout << std::endl;
+	std::cout << regressions << " regressions, " << improvements << " improvements over " << std::setprecision(1) << threshold << "% at alpha " << std::setprecision(3) << alpha;
+	if (missing) {
+		std::cout << ", " << missing << " variants only in one file";
+	}
+	std::cout << std::endl;
+
+	return regressions ? 2 : 0;
+}
@@ -17,8 +17,7 @@
 * along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <cycle.h>
-#include <helpers.hpp>
+#include <bench.hpp>
 
 #include <cstdlib>
 #include <cstdint>
@@ -30,7 +29,6 @@
 #include <iomanip>
 
 const size_t N = 1000000;
-const size_t R = 7;
 std::vector<uint32_t> numbers;
 
 enum TYPES {
@@ -100,309 +98,204 @@ struct TwoLevel1 : TwoBase {
     }
 };
 
-int main() {
-    std::vector< std::vector<double> > timings(17);
+int main(int argc, char *argv[]) {
+    bench::Runner runner(argc, argv);
+    for (size_t n : runner.sizes(1000000)) {
+        const size_t N = n;
+        runner.n = N;
 
-    for (size_t r=0 ; r<R ; ++r) {
         OneBase a;
         OneLevel1 b;
         OneLevel2 c;
         OneLevel3 d;
         OneBase* ones[] = {&a, &b, &c, &d};
 
-        ticks start, end;
-        double timed = 0.0;
-        size_t res = 0;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneLevel3 *a = reinterpret_cast<OneLevel3*>(ones[3]);
-            res += a->getType();
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[0].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            if (ones[2]->getType() == T_ONE_LEVEL2) {
-                OneLevel2 *a = reinterpret_cast<OneLevel2*>(ones[2]);
+        runner.add("reinterpret_cast known-type", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneLevel3 *a = reinterpret_cast<OneLevel3*>(ones[3]);
                 res += a->getType();
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[1].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneBase *a = dynamic_cast<OneBase*>(ones[0]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("virtual function + reinterpret_cast", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                if (ones[2]->getType() == T_ONE_LEVEL2) {
+                    OneLevel2 *a = reinterpret_cast<OneLevel2*>(ones[2]);
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[2].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneLevel1 *a = dynamic_cast<OneLevel1*>(ones[1]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("member variable + reinterpret_cast", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                if (ones[3]->type == T_ONE_LEVEL3) {
+                    OneLevel3 *a = reinterpret_cast<OneLevel3*>(ones[3]);
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[3].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneLevel2 *a = dynamic_cast<OneLevel2*>(ones[2]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast same-type-base success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneBase *a = dynamic_cast<OneBase*>(ones[0]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[4].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneLevel3 *a = dynamic_cast<OneLevel3*>(ones[3]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast same-type-level1 success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneLevel1 *a = dynamic_cast<OneLevel1*>(ones[1]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[5].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneBase *a = dynamic_cast<OneBase*>(ones[1]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast same-type-level2 success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneLevel2 *a = dynamic_cast<OneLevel2*>(ones[2]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[6].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneBase *a = dynamic_cast<OneBase*>(ones[2]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast same-type-level3 success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneLevel3 *a = dynamic_cast<OneLevel3*>(ones[3]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[7].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneBase *a = dynamic_cast<OneBase*>(ones[3]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast level1-to-base success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneBase *a = dynamic_cast<OneBase*>(ones[1]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[8].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneLevel1 *a = dynamic_cast<OneLevel1*>(ones[2]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast level2-to-base success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneBase *a = dynamic_cast<OneBase*>(ones[2]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[9].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneLevel1 *a = dynamic_cast<OneLevel1*>(ones[3]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast level3-to-base success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneBase *a = dynamic_cast<OneBase*>(ones[3]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[10].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            OneLevel2 *a = dynamic_cast<OneLevel2*>(ones[3]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast level2-to-level1 success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneLevel1 *a = dynamic_cast<OneLevel1*>(ones[2]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[11].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            TwoBase *a = dynamic_cast<TwoBase*>(ones[0]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast level3-to-level1 success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneLevel1 *a = dynamic_cast<OneLevel1*>(ones[3]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[12].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            TwoBase *a = dynamic_cast<TwoBase*>(ones[1]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast level3-to-level2 success", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                OneLevel2 *a = dynamic_cast<OneLevel2*>(ones[3]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[13].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            TwoBase *a = dynamic_cast<TwoBase*>(ones[2]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast onebase-to-twobase fail", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                TwoBase *a = dynamic_cast<TwoBase*>(ones[0]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[14].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            TwoBase *a = dynamic_cast<TwoBase*>(ones[3]);
-            if (a) {
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast onelevel1-to-twobase fail", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                TwoBase *a = dynamic_cast<TwoBase*>(ones[1]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[15].push_back(timed);
-        std::cerr << res << std::endl;
-
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            if (ones[3]->type == T_ONE_LEVEL3) {
-                OneLevel3 *a = reinterpret_cast<OneLevel3*>(ones[3]);
-                res += a->getType();
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast onelevel2-to-twobase fail", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                TwoBase *a = dynamic_cast<TwoBase*>(ones[2]);
+                if (a) {
+                    res += a->getType();
+                }
+            }
+            bench::keep(res);
+        });
+
+        runner.add("dynamic_cast onelevel3-to-twobase fail", [&]() {
+            size_t res = 0;
+            for (size_t i=0 ; i<N ; ++i) {
+                TwoBase *a = dynamic_cast<TwoBase*>(ones[3]);
+                if (a) {
+                    res += a->getType();
+                }
             }
-        }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[16].push_back(timed);
-        std::cerr << res << std::endl;
+            bench::keep(res);
+        });
 
-        std::cerr << std::endl;
+        runner.run();
     }
-
-    std::cout << "reinterpret_cast known-type: ";
-    PrintStats(timings[0]);
-    std::cout << std::endl;
-
-    std::cout << "virtual function + reinterpret_cast: ";
-    PrintStats(timings[1]);
-    std::cout << std::endl;
-
-    std::cout << "member variable + reinterpret_cast: ";
-    PrintStats(timings[16]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast same-type-base success: ";
-    PrintStats(timings[2]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast same-type-level1 success: ";
-    PrintStats(timings[3]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast same-type-level2 success: ";
-    PrintStats(timings[4]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast same-type-level3 success: ";
-    PrintStats(timings[5]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast level1-to-base success: ";
-    PrintStats(timings[6]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast level2-to-base success: ";
-    PrintStats(timings[7]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast level3-to-base success: ";
-    PrintStats(timings[8]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast level2-to-level1 success: ";
-    PrintStats(timings[9]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast level3-to-level1 success: ";
-    PrintStats(timings[10]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast level3-to-level2 success: ";
-    PrintStats(timings[11]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast onebase-to-twobase fail: ";
-    PrintStats(timings[12]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast onelevel1-to-twobase fail: ";
-    PrintStats(timings[13]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast onelevel2-to-twobase fail: ";
-    PrintStats(timings[14]);
-    std::cout << std::endl;
-
-    std::cout << "dynamic_cast onelevel3-to-twobase fail: ";
-    PrintStats(timings[15]);
-    std::cout << std::endl;
-
-    std::cout << std::endl;
+    runner.curve();
 }
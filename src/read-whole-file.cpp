@@ -17,8 +17,7 @@
 * along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <cycle.h>
-#include <helpers.hpp>
+#include <bench.hpp>
 
 #include <cstdlib>
 #include <cstdio>
@@ -32,8 +31,6 @@
 #include <sstream>
 #include <sys/stat.h>
 
-static const size_t R = 7;
-
 std::string read_whole_file_sstream(const char *fname) {
     std::ifstream file(fname, std::ios::binary);
     std::ostringstream ss;
@@ -83,105 +80,33 @@ std::string read_whole_file_stat_C(const char *fname) {
     return result;
 }
 
-int main() {
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
-            std::string a = read_whole_file_sstream("random100");
-            tlen += a.length();
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "Stringstream: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
-            std::string a = read_whole_file_iterator("random100");
-            tlen += a.length();
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "Iterator: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
-            std::string a = read_whole_file_seek("random100");
-            tlen += a.length();
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "Seek: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
-            std::string a = read_whole_file_stat("random100");
-            tlen += a.length();
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "Stat: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
-            std::string a = read_whole_file_stat_C("random100");
-            tlen += a.length();
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "Stat C: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
+int main(int argc, char *argv[]) {
+    bench::Runner runner(argc, argv);
+
+    runner.add("Stringstream", [&]() {
+        std::string a = read_whole_file_sstream("random100");
+        bench::keep(a.length());
+    });
+
+    runner.add("Iterator", [&]() {
+        std::string a = read_whole_file_iterator("random100");
+        bench::keep(a.length());
+    });
+
+    runner.add("Seek", [&]() {
+        std::string a = read_whole_file_seek("random100");
+        bench::keep(a.length());
+    });
+
+    runner.add("Stat", [&]() {
+        std::string a = read_whole_file_stat("random100");
+        bench::keep(a.length());
+    });
+
+    runner.add("Stat C", [&]() {
+        std::string a = read_whole_file_stat_C("random100");
+        bench::keep(a.length());
+    });
+
+    runner.run();
 }
@@ -0,0 +1,230 @@
+/*
+* Copyright (C) 2026, Tino Didriksen <mail@tinodidriksen.com>
+*
+* This file is part of Benchmarks
+*
+* Benchmarks is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Benchmarks is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.hpp>
+#include <workloads.hpp>
+#include <concurrent.hpp>
+
+#include <btree_set.h>
+#include <olc_btree_set.h>
+
+#include <set>
+#include <unordered_set>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The phases every kernel runs, each split evenly between the threads
+const char *phase_names[] = { "insertion", "lookup", "erase" };
+const size_t PHASES = sizeof(phase_names) / sizeof(phase_names[0]);
+
+// Thread i's share of N keys
+inline size_t sliceBegin(size_t N, size_t threads, size_t i) {
+    return N * i / threads;
+}
+
+// Inserts, looks up and erases every key, the threads each taking a slice of
+// the keys, and adds every operation's ticks to hists[phase] if given
+template<bool Latency, typename Cont, typename T>
+size_t runPhases(const std::vector<T>& values, size_t threads, bench::Timer *t, std::vector<bench::Histogram> *hists = 0, double overhead = 0.0) {
+    const size_t N = values.size();
+    Cont Set;
+    std::atomic<size_t> res(0);
+    for (size_t p=0 ; p<PHASES ; ++p) {
+        bench::run_threads(threads, [&](size_t i) {
+            bench::Histogram *hist = Latency ? &hists[p][i] : 0;
+            size_t r = 0;
+            ticks begin = ticks();
+            for (size_t k=sliceBegin(N, threads, i), e=sliceBegin(N, threads, i + 1) ; k<e ; ++k) {
+                if (Latency) {
+                    begin = getticks();
+                }
+                if (p == 0) {
+                    r += Set.insert(values[k]);
+                }
+                else if (p == 1) {
+                    r += Set.contains(values[k]);
+                }
+                else {
+                    r += Set.erase(values[k]);
+                }
+                if (Latency) {
+                    hist->add(elapsed(getticks(), begin) - overhead);
+                }
+            }
+            res += r;
+        }, t, p);
+    }
+    return res.load();
+}
+
+// Runs the phases once more with every operation timed, and attaches latency
+// percentiles per phase across all threads to the last registered kernel
+template<typename Cont, typename T>
+void latencyTest(bench::Runner& runner, const std::vector<T>& values, size_t threads) {
+    const bench::Clock& clock = runner.calibration();
+    std::vector<bench::Histogram> hists[PHASES];
+    for (size_t p=0 ; p<PHASES ; ++p) {
+        hists[p].resize(threads);
+    }
+    bench::keep(runPhases<true, Cont>(values, threads, 0, hists, clock.overhead));
+    for (size_t p=0 ; p<PHASES ; ++p) {
+        bench::Histogram all;
+        for (size_t i=0 ; i<threads ; ++i) {
+            all.merge(hists[p][i]);
+        }
+        std::string name = phase_names[p];
+        runner.metric(name + "_p50_ns", clock.to_ns(all.percentile(0.50)));
+        runner.metric(name + "_p99_ns", clock.to_ns(all.percentile(0.99)));
+        runner.metric(name + "_p999_ns", clock.to_ns(all.percentile(0.999)));
+        runner.metric(name + "_max_ns", clock.to_ns(all.max()));
+    }
+}
+
+double metricValue(const bench::Result& res, const std::string& name) {
+    for (size_t i=0 ; i<res.metrics.size() ; ++i) {
+        if (res.metrics[i].first == name) {
+            return res.metrics[i].second;
+        }
+    }
+    return 0.0;
+}
+
+// Per phase, throughput in Mops/s at each thread count, its scaling
+// efficiency against the first thread count, and the p99 latency
+template<typename Cont, typename T>
+void runTest(bench::Runner& runner, const std::string& type, const std::string& name, const std::vector<T>& values, const std::vector<size_t>& threads) {
+    std::vector<std::string> phases(phase_names, phase_names + PHASES);
+    for (size_t ti=0 ; ti<threads.size() ; ++ti) {
+        const size_t count = threads[ti];
+        const std::string kernel = name + "<" + type + "> threads=" + std::to_string(count);
+        runner.add(kernel, phases, [&values, count](bench::Timer& t) {
+            bench::keep(runPhases<false, Cont>(values, count, &t));
+        });
+        if (!runner.list && runner.selected(kernel)) {
+            latencyTest<Cont>(runner, values, count);
+        }
+    }
+
+    std::vector<bench::Result> timings = runner.run();
+    if (timings.empty()) {
+        return;
+    }
+    const bench::Clock& clock = runner.calibration();
+    std::cout << std::fixed;
+    for (size_t p=0 ; p<PHASES ; ++p) {
+        std::vector<const bench::Result*> row;
+        std::vector<size_t> counts;
+        for (size_t i=0 ; i<timings.size() ; ++i) {
+            if (timings[i].phase == phase_names[p]) {
+                row.push_back(&timings[i]);
+                counts.push_back(std::stoul(timings[i].name.substr(timings[i].name.rfind('=') + 1)));
+            }
+        }
+        if (row.empty()) {
+            continue;
+        }
+        std::vector<double> mops;
+        for (size_t i=0 ; i<row.size() ; ++i) {
+            mops.push_back(double(row[i]->n) / clock.to_ns(row[i]->fastest) * 1e3);
+        }
+        std::cout << name << " " << phase_names[p] << "\tMops/s" << std::setprecision(2);
+        for (size_t i=0 ; i<row.size() ; ++i) {
+            std::cout << "\t" << mops[i];
+        }
+        std::cout << std::endl << name << " " << phase_names[p] << "\tscaling" << std::setprecision(0);
+        for (size_t i=0 ; i<row.size() ; ++i) {
+            double ideal = mops[0] * double(counts[i]) / double(counts[0]);
+            std::cout << "\t" << mops[i] / ideal * 100.0 << "%";
+        }
+        std::cout << std::endl << name << " " << phase_names[p] << "\tp99 ns" << std::setprecision(0);
+        for (size_t i=0 ; i<row.size() ; ++i) {
+            std::cout << "\t" << metricValue(*row[i], std::string(phase_names[p]) + "_p99_ns");
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// Benchmark specific settings:
+//  -p keys=NAME     key distribution, see workloads.hpp (default dense)
+//  -p threads=LIST  thread counts to run at, e.g. 1..64 (default 1 and
+//                   powers of 2 up to the number of hardware threads)
+// Leave out --cpu, which would pin every thread to that one CPU. --perf
+// reports no counters, since they would only count the main thread.
+int main(int argc, char *argv[]) {
+    bench::Runner runner(argc, argv);
+    runner.threaded();
+    bench::KeyDistribution dist;
+    const std::string threads_spec = runner.param("threads", "");
+    std::vector<size_t> threads;
+    try {
+        dist = bench::KeyDistribution::parse(runner.param("keys", "dense"));
+        if (threads_spec.empty()) {
+            const size_t hw = std::max<size_t>(1, std::thread::hardware_concurrency());
+            for (size_t t=1 ; t<hw ; t *= 2) {
+                threads.push_back(t);
+            }
+            threads.push_back(hw);
+        }
+        else {
+            threads = bench::parse_sizes(threads_spec);
+            if (std::find(threads.begin(), threads.end(), size_t(0)) != threads.end()) {
+                throw std::invalid_argument("thread counts must be at least 1: " + threads_spec);
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<size_t> sizes = runner.sizes(1000000);
+    for (size_t si=0 ; si<sizes.size() ; ++si) {
+        const size_t N = sizes[si];
+        runner.n = N;
+        std::vector<uint32_t> values = dist.generate<uint32_t>(N);
+        // Duplicates would make the threads' slices overlap
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        std::shuffle(values.begin(), values.end(), std::mt19937(1549556379));
+        runner.n = values.size();
+        runner.size = N;
+
+        std::cout << "<uint32_t>\tthreads";
+        for (size_t i=0 ; i<threads.size() ; ++i) {
+            std::cout << "\t" << threads[i];
+        }
+        std::cout << std::endl;
+        runTest< bench::locked_set< std::set<uint32_t> > >(runner, "uint32_t", "std::set[mutex]", values, threads);
+        runTest< bench::striped_set< std::unordered_set<uint32_t> > >(runner, "uint32_t", "std::unordered_set[striped]", values, threads);
+        runTest< bench::locked_set< btree::btree_set<uint32_t>, std::shared_mutex > >(runner, "uint32_t", "btree::btree_set[shared_mutex]", values, threads);
+        runTest< btree::olc_btree_set<uint32_t> >(runner, "uint32_t", "btree::olc_btree_set", values, threads);
+    }
+    runner.curve();
+}
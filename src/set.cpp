@@ -17,152 +17,999 @@
 * along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <cycle.h>
-#include <helpers.hpp>
+#include <bench.hpp>
+#include <counting_allocator.hpp>
+#include <workloads.hpp>
+#include <concurrent.hpp>
 
 #include <boost/unordered_set.hpp>
 #include <boost/container/flat_set.hpp>
+#include <flat_hash_set.hpp>
+#include <robin_hood_set.hpp>
+#include <eytzinger_set.hpp>
+#include <static_btree_set.hpp>
 #include <sorted_vector.hpp>
 #include <interval_vector.hpp>
 #include <sorted_deque.hpp>
 #include <tdc_trie.hpp>
 #include <btree_set.h>
+#include <btree_arena.h>
+#include <olc_btree_set.h>
 #include <safe_btree_set.h>
 #ifdef _MSC_VER
     #include <sti/sset.h>
 #endif
 #include <set>
 #include <unordered_set>
+#include <thread>
+#include <atomic>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <sstream>
+#include <stdexcept>
 
-const size_t N = 1000000;
-const size_t R = 7;
+template<typename T>
+using counted_set = std::set<T, std::less<T>, bench::counting_allocator<T> >;
+template<typename T>
+using counted_unordered_set = std::unordered_set<T, std::hash<T>, std::equal_to<T>, bench::counting_allocator<T> >;
+template<typename T>
+using counted_boost_unordered_set = boost::unordered_set<T, boost::hash<T>, std::equal_to<T>, bench::counting_allocator<T> >;
+template<typename T>
+using counted_flat_hash_set = bench::flat_hash_set<T, std::hash<T>, std::equal_to<T>, bench::counting_allocator<T> >;
+template<typename T>
+using counted_robin_hood_set = bench::robin_hood_set<T, std::hash<T>, std::equal_to<T>, bench::counting_allocator<T> >;
+template<typename T>
+using counted_flat_set = boost::container::flat_set<T, std::less<T>, bench::counting_allocator<T> >;
+template<typename T>
+using counted_btree_set = btree::btree_set<T, std::less<T>, bench::counting_allocator<T> >;
+// btree_set at a given TargetNodeSize, for the -p nodes= sweep
+template<typename T, int Size>
+using sized_btree_set = btree::btree_set<T, std::less<T>, std::allocator<T>, Size>;
+template<typename T, int Size>
+using counted_sized_btree_set = btree::btree_set<T, std::less<T>, bench::counting_allocator<T>, Size>;
+// btree_set with a given intra-node search; the default for integers is linear
+template<typename T, typename Search>
+using search_btree_set = btree::btree_set<T, std::less<T>, std::allocator<T>, 256, Search>;
+// btree_set prefetching nodes during descent and iteration; it only pays off
+// once the tree outgrows the LLC, e.g. -n 50M
+template<typename T>
+using prefetch_btree_set = btree::btree_set<T, std::less<T>, std::allocator<T>, 256, btree::btree_default_search, btree::btree_prefetch>;
+// btree_set carving its nodes from a private arena, so inserts and erases
+// skip the heap and destruction frees whole chunks
+template<typename T>
+using arena_btree_set = btree::btree_set<T, std::less<T>, btree::btree_arena_allocator<T> >;
 
+// Figures particular to a kind of container, added to its memory metrics
+template<typename Cont>
+void containerStats(bench::Runner&, const Cont&) {
+}
+
+template<typename K, typename C, typename A, int N, typename S, typename F>
+void containerStats(bench::Runner& runner, const btree::btree_set<K, C, A, N, S, F>& Set) {
+    runner.metric("btree_bytes_used", double(Set.bytes_used()));
+    runner.metric("btree_fullness", Set.fullness());
+    runner.metric("btree_overhead", Set.overhead());
+}
+
+// How far keys sit from their home slot, which bounds the probes a lookup makes
+template<typename T, typename H, typename E, typename A>
+void containerStats(bench::Runner& runner, const bench::robin_hood_set<T, H, E, A>& Set) {
+    bench::ProbeStats probes = Set.probe_stats();
+    size_t p99 = 0;
+    for (size_t seen=0 ; p99<probes.histogram.size() ; ++p99) {
+        seen += probes.histogram[p99];
+        if (seen * 100 >= Set.size() * 99) {
+            break;
+        }
+    }
+    runner.metric("load_factor", Set.load_factor());
+    runner.metric("probe_avg", probes.average);
+    runner.metric("probe_p99", double(p99));
+    runner.metric("probe_max", double(probes.max));
+}
+
+// Fills a container that uses bench::counting_allocator once, untimed, and
+// attaches its memory use to the last registered kernel
+template<typename Counted>
+struct MemoryTest {
+    template<typename VT>
+    static void run(bench::Runner& runner, const VT& values) {
+        bench::AllocStats& stats = bench::alloc_stats();
+        stats.reset();
+        Counted Set;
+        for (size_t i=0 ; i<values.size() ; ++i) {
+            Set.insert(values[i]);
+        }
+        runner.metric("elements", double(Set.size()));
+        runner.metric("live_bytes", double(stats.live));
+        runner.metric("peak_bytes", double(stats.peak));
+        runner.metric("allocations", double(stats.allocations));
+        runner.metric("bytes_per_element", double(stats.live) / double(Set.size()));
+        containerStats(runner, Set);
+    }
+};
+
+// Containers that don't take an allocator
+template<>
+struct MemoryTest<void> {
+    template<typename VT>
+    static void run(bench::Runner&, const VT&) {
+    }
+};
+
+// The keys runTest() inserts, and the ones it looks up besides those
+template<typename T>
+struct Keys {
+    std::vector<T> values;
+    // Keys not in values; empty unless -p hits= is given
+    std::vector<T> misses;
+    // Lookups hitting values at the -p hits= ratio and missing otherwise
+    std::vector<T> queries;
+    // Range query windows per -p ranges= span
+    std::vector< std::vector< std::pair<T, T> > > windows;
+};
+
+// What runTest() runs against, besides the keys themselves
+struct Workload {
+    std::string type;
+    // Kernel name suffix of the key distribution
+    std::string keys;
+    // Operation trace for the mixed kernel; empty unless -p mix= is given
+    std::vector<bench::Op> trace;
+    // Elements per range query window; empty unless -p ranges= is given
+    std::vector<size_t> spans;
+};
+
+// Containers with lower_bound() and sorted iteration
+template<typename Cont>
+struct Ordered {
+    static const bool value = false;
+};
+
+template<typename... A>
+struct Ordered< std::set<A...> > {
+    static const bool value = true;
+};
+
+template<typename... A>
+struct Ordered< boost::container::flat_set<A...> > {
+    static const bool value = true;
+};
+
+template<typename... A>
+struct Ordered< CG3::sorted_vector<A...> > {
+    static const bool value = true;
+};
+
+template<typename... A>
+struct Ordered< CG3::sorted_deque<A...> > {
+    static const bool value = true;
+};
+
+template<typename K, typename C, typename A, int N, typename S, typename F>
+struct Ordered< btree::btree_set<K, C, A, N, S, F> > {
+    static const bool value = true;
+};
+
+// Registers one kernel per window span that times seeking to the start of
+// each window separately from scanning it, for ordered containers only
+template<bool Ordered>
+struct RangeTest {
+    template<typename Cont, typename T>
+    static void add(bench::Runner&, const Workload&, const std::string&, const Keys<T>&) {
+    }
+};
+
+template<>
+struct RangeTest<true> {
+    template<typename Cont, typename T>
+    static void add(bench::Runner& runner, const Workload& w, const std::string& kernel, const Keys<T>& keys) {
+        const std::vector<T> *values = &keys.values;
+        const size_t n = runner.n;
+        runner.size = values->size();
+        for (size_t r=0 ; r<keys.windows.size() ; ++r) {
+            const std::vector< std::pair<T, T> > *windows = &keys.windows[r];
+            runner.n = windows->size();
+            runner.add(kernel + " range " + std::to_string(w.spans[r]), {"seek", "scan"}, [values, windows](bench::Timer& t) {
+                size_t heap = bench::heap_in_use();
+                Cont Set;
+                for (size_t i=0 ; i<values->size() ; ++i) {
+                    Set.insert((*values)[i]);
+                }
+                size_t used = bench::heap_in_use();
+                t.working_set(used > heap ? used - heap : 0);
+
+                const Cont& cs = Set;
+                std::vector<typename Cont::const_iterator> starts(windows->size());
+                t.start();
+                for (size_t q=0 ; q<windows->size() ; ++q) {
+                    starts[q] = cs.lower_bound((*windows)[q].first);
+                }
+                t.stop(0);
+
+                size_t res = 0;
+                t.start();
+                for (size_t q=0 ; q<windows->size() ; ++q) {
+                    const T& hi = (*windows)[q].second;
+                    for (typename Cont::const_iterator it = starts[q] ; it != cs.end() && *it < hi ; ++it) {
+                        res += checkvalue(*it);
+                    }
+                }
+                t.stop(1);
+                bench::keep(res);
+            });
+        }
+        runner.n = n;
+        runner.size = 0;
+    }
+};
+
+// Replays an operation trace, optionally timing each operation
+template<bool Latency, typename Cont, typename VT>
+size_t replay(Cont& Set, const VT& values, const std::vector<bench::Op>& trace, bench::Histogram *hist = 0, double overhead = 0.0) {
+    size_t res = 0;
+    ticks begin = ticks();
+    for (size_t i=0 ; i<trace.size() ; ++i) {
+        const bench::Op& op = trace[i];
+        if (Latency) {
+            begin = getticks();
+        }
+        if (op.type == bench::OP_LOOKUP) {
+            typename Cont::const_iterator it = Set.find(values[op.key]);
+            if (it != Set.end()) {
+                res += checkvalue(*it);
+            }
+        }
+        else if (op.type == bench::OP_INSERT) {
+            Set.insert(values[op.key]);
+        }
+        else {
+            Set.erase(values[op.key]);
+        }
+        if (Latency) {
+            hist[op.type].add(elapsed(getticks(), begin) - overhead);
+        }
+    }
+    return res;
+}
+
+// Replays the trace once more, timing every operation, and attaches latency
+// percentiles per operation type to the last registered kernel
 template<typename Cont, typename VT>
-void runTest(const std::string& name, const VT& values) {
-    std::cout << "Testing " << name << " ..." << std::endl;
+void latencyTest(bench::Runner& runner, const VT& values, const std::vector<bench::Op>& trace) {
+    Cont Set;
+    for (size_t i=0 ; i<values.size()/2 ; ++i) {
+        Set.insert(values[i]);
+    }
+    bench::Histogram hist[bench::OP_TYPES];
+    const bench::Clock& clock = runner.calibration();
+    bench::keep(replay<true>(Set, values, trace, hist, clock.overhead));
+    for (size_t t=0 ; t<bench::OP_TYPES ; ++t) {
+        if (hist[t].count() == 0) {
+            continue;
+        }
+        std::string op = bench::op_name(t);
+        runner.metric(op + "_count", double(hist[t].count()));
+        runner.metric(op + "_p50_ns", clock.to_ns(hist[t].percentile(0.50)));
+        runner.metric(op + "_p90_ns", clock.to_ns(hist[t].percentile(0.90)));
+        runner.metric(op + "_p99_ns", clock.to_ns(hist[t].percentile(0.99)));
+        runner.metric(op + "_p999_ns", clock.to_ns(hist[t].percentile(0.999)));
+        runner.metric(op + "_max_ns", clock.to_ns(hist[t].max()));
+    }
+}
 
-    std::vector< std::vector<double> > timings(4);
+void printMetrics(const std::string& label, const std::vector< std::pair<std::string, double> >& metrics) {
+    if (metrics.empty()) {
+        return;
+    }
+    std::cout << label << ":";
+    for (size_t i=0 ; i<metrics.size() ; ++i) {
+        double v = metrics[i].second;
+        std::cout << (i ? ", " : " ") << metrics[i].first << " " << std::setprecision(v == double(size_t(v)) ? 0 : 2) << v;
+    }
+    std::cout << std::endl;
+}
+
+// Tabulates the percentiles latencyTest() attached
+void printLatencies(const std::vector< std::pair<std::string, double> >& metrics) {
+    const char *columns[] = { "p50", "p90", "p99", "p999", "max" };
+    std::cout << "latency ns\tp50\tp90\tp99\tp99.9\tmax" << std::endl;
+    for (size_t t=0 ; t<bench::OP_TYPES ; ++t) {
+        std::string op = bench::op_name(t);
+        std::string row = op;
+        size_t found = 0;
+        for (size_t c=0 ; c<5 ; ++c) {
+            for (size_t i=0 ; i<metrics.size() ; ++i) {
+                if (metrics[i].first == op + "_" + columns[c] + "_ns") {
+                    std::ostringstream ss;
+                    ss << std::fixed << std::setprecision(0) << metrics[i].second;
+                    row += "\t" + ss.str();
+                    ++found;
+                }
+            }
+        }
+        if (found) {
+            std::cout << row << std::endl;
+        }
+    }
+}
+
+template<typename Cont, typename VT>
+size_t lookup(const Cont& Set, const VT& values) {
+    size_t res = 0;
+    for (size_t i=0 ; i<values.size() ; ++i) {
+        typename Cont::const_iterator it = Set.find(values[i]);
+        if (it != Set.end()) {
+            res += checkvalue(*it);
+        }
+    }
+    return res;
+}
+
+// Containers with find_batch()
+template<typename Cont>
+struct Batched {
+    static const bool value = false;
+};
+
+template<typename K, typename C, typename A, int N, typename S, typename F>
+struct Batched< btree::btree_set<K, C, A, N, S, F> > {
+    static const bool value = true;
+};
+
+// Looks up keys with find_batch() a chunk at a time
+template<typename Cont, typename VT>
+size_t lookupBatch(const Cont& Set, const VT& values) {
+    std::vector<typename Cont::const_iterator> found(1024);
+    size_t res = 0;
+    for (size_t i=0 ; i<values.size() ; i += found.size()) {
+        size_t n = std::min(found.size(), values.size() - i);
+        Set.find_batch(values.begin() + i, values.begin() + i + n, found.begin());
+        for (size_t j=0 ; j<n ; ++j) {
+            if (found[j] != Set.end()) {
+                res += checkvalue(*found[j]);
+            }
+        }
+    }
+    return res;
+}
+
+// Registers a kernel timing the lookup phases again with find_batch(), for
+// containers that have it
+template<bool Batched>
+struct BatchTest {
+    template<typename Cont, typename T>
+    static void add(bench::Runner&, const std::string&, const Keys<T>&) {
+    }
+};
 
-    for (size_t r=0 ; r<R ; ++r) {
+template<>
+struct BatchTest<true> {
+    template<typename Cont, typename T>
+    static void add(bench::Runner& runner, const std::string& kernel, const Keys<T>& keys) {
+        std::vector<std::string> phases = {"lookup"};
+        if (!keys.misses.empty()) {
+            phases.push_back("miss lookup");
+        }
+        runner.add(kernel + " batch", phases, [&keys](bench::Timer& t) {
+            size_t heap = bench::heap_in_use();
+            Cont Set;
+            for (size_t i=0 ; i<keys.values.size() ; ++i) {
+                Set.insert(keys.values[i]);
+            }
+            size_t used = bench::heap_in_use();
+            t.working_set(used > heap ? used - heap : 0);
+
+            t.start();
+            size_t res = lookupBatch(Set, keys.values);
+            t.stop(0);
+            bench::keep(res);
+
+            if (!keys.misses.empty()) {
+                t.start();
+                res = lookupBatch(Set, keys.misses);
+                t.stop(1);
+                bench::keep(res);
+            }
+        });
+    }
+};
+
+template<typename Cont, typename Counted = void, typename T>
+void runTest(bench::Runner& runner, const Workload& w, const std::string& name, const Keys<T>& keys) {
+    const std::vector<T>& values = keys.values;
+    const size_t N = values.size();
+    const std::string kernel = name + "<" + w.type + ">" + w.keys;
+    // Misses and mixed lookups run against the full set, but are numbered
+    // last so the classic four phases keep their place
+    std::vector<std::string> phases = {"insertion", "lookup", "iterate", "erase"};
+    if (!keys.misses.empty()) {
+        phases.push_back("miss lookup");
+        phases.push_back("mixed lookup");
+    }
+    runner.add(kernel, phases, [&](bench::Timer& t) {
+        size_t heap = bench::heap_in_use();
         Cont Set;
-        ticks start, end;
-        double timed = 0.0;
         size_t res = 0;
 
-        start = getticks();
+        t.start();
         for (size_t i=0 ; i<N ; ++i) {
             Set.insert(values[i]);
         }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[0].push_back(timed);
+        t.stop(0);
+        size_t used = bench::heap_in_use();
+        t.working_set(used > heap ? used - heap : 0);
 
-        res = 0;
-        start = getticks();
-        for (size_t i=0 ; i<N ; ++i) {
-            typename Cont::const_iterator it = Set.find(values[i]);
-            if (it != Set.end()) {
-                res += checkvalue(*it);
-            }
+        t.start();
+        res = lookup(Set, values);
+        t.stop(1);
+        bench::keep(res);
+
+        if (!keys.misses.empty()) {
+            t.start();
+            res = lookup(Set, keys.misses);
+            t.stop(4);
+            bench::keep(res);
+
+            t.start();
+            res = lookup(Set, keys.queries);
+            t.stop(5);
+            bench::keep(res);
         }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[1].push_back(timed);
-        std::cerr << res << std::endl;
 
         res = 0;
         size_t n = 0;
-        start = getticks();
+        t.start();
         for (typename Cont::const_iterator it = Set.begin(); it != Set.end() ; ++it) {
             res += checkvalue(*it);
             ++n;
         }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[2].push_back(timed);
-        std::cerr << res << std::endl;
-        std::cerr << n << std::endl;
+        t.stop(2);
+        bench::keep(res);
+        bench::keep(n);
 
-        start = getticks();
+        t.start();
         for (size_t i=0 ; i<N ; ++i) {
             Set.erase(values[i]);
         }
-        end = getticks();
-        timed = elapsed(end, start);
-        timings[3].push_back(timed);
+        t.stop(3);
+    });
+
+    if (!runner.list && runner.selected(kernel)) {
+        MemoryTest<Counted>::run(runner, values);
+    }
+
+    // Interleaved operations against a set preloaded with the first half of
+    // the keys, which are also the hottest ones
+    if (!w.trace.empty()) {
+        runner.add(kernel + " mix", {""}, [&](bench::Timer& t) {
+            Cont Set;
+            for (size_t i=0 ; i<N/2 ; ++i) {
+                Set.insert(values[i]);
+            }
+            t.start();
+            size_t res = replay<false>(Set, values, w.trace);
+            t.stop();
+            bench::keep(res);
+        });
+        if (!runner.list && runner.selected(kernel + " mix")) {
+            latencyTest<Cont>(runner, values, w.trace);
+        }
+    }
+
+    RangeTest<Ordered<Cont>::value>::template add<Cont>(runner, w, kernel, keys);
+    BatchTest<Batched<Cont>::value>::template add<Cont>(runner, kernel, keys);
+
+    std::vector<bench::Result> timings = runner.run();
+    if (timings.empty()) {
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(0);
+    for (size_t i=0 ; i<timings.size() ; ++i) {
+        if (timings[i].phase == "insertion" && i + 4 <= timings.size()) {
+            std::cout << name << "\t" << timings[i].fastest << "\t" << timings[i+1].fastest << "\t" << timings[i+2].fastest << "\t" << timings[i+3].fastest;
+            if (!keys.misses.empty() && i + 6 <= timings.size()) {
+                std::cout << "\t" << timings[i+4].fastest << "\t" << timings[i+5].fastest;
+            }
+            std::cout << std::endl;
+            printMetrics("memory", timings[i].metrics);
+        }
+        else if (timings[i].phase.empty()) {
+            const bench::Result& mix = timings[i];
+            double ns = runner.calibration().to_ns(bench::median(mix.timings));
+            std::cout << name << " mix\t" << std::setprecision(2) << double(mix.n) / ns * 1e3 << " Mops/s" << std::endl;
+            printLatencies(mix.metrics);
+        }
+        else if (timings[i].name == kernel + " batch") {
+            // Under the Lookup and Miss columns
+            std::cout << name << " batch\t\t" << std::setprecision(0) << timings[i].fastest;
+            for (++i ; i<timings.size() && timings[i].name == kernel + " batch" ; ++i) {
+                std::cout << "\t\t\t" << timings[i].fastest;
+            }
+            --i;
+            std::cout << std::endl;
+        }
+        else if (timings[i].phase == "seek" && i + 2 <= timings.size()) {
+            const bench::Clock& clock = runner.calibration();
+            double q = double(timings[i].n);
+            std::cout << name << timings[i].name.substr(kernel.size()) << "\tseek " << std::setprecision(1) << clock.to_ns(timings[i].fastest) / q;
+            std::cout << " ns, scan " << clock.to_ns(timings[i+1].fastest) / q << " ns per query" << std::endl;
+        }
     }
 
-    std::cout << name << " insertion: ";
-    timings[0][0] = PrintStats(timings[0]);
     std::cout << std::endl;
+}
+
+// Registers a kernel that times building a container from sorted keys
+template<typename Cont, typename T, typename Build>
+void addBuild(bench::Runner& runner, const std::string& name, const std::vector<T>& sorted, Build build) {
+    runner.add(name, {""}, [&sorted, build](bench::Timer& t) {
+        size_t heap = bench::heap_in_use();
+        Cont Set;
+        t.start();
+        build(Set, sorted);
+        t.stop();
+        size_t used = bench::heap_in_use();
+        t.working_set(used > heap ? used - heap : 0);
+        bench::keep(Set.size());
+    });
+}
+
+// Index rebuilds from sorted snapshots: the btree filled one insert at a time
+// and bulk loaded, against the cheapest sorted paths of flat_set and std::set
+template<typename T>
+void buildTest(bench::Runner& runner, const Workload& w, const std::vector<T>& values, double fill) {
+    std::vector<T> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    const std::string suffix = "<" + w.type + ">" + w.keys + " build";
+    const size_t n = runner.n;
+    runner.n = sorted.size();
+    runner.size = values.size();
 
-    std::cout << name << " lookup: ";
-    timings[1][0] = PrintStats(timings[1]);
+    addBuild< btree::btree_set<T> >(runner, "btree::btree_set" + suffix + " insert", sorted, [](btree::btree_set<T>& Set, const std::vector<T>& v) {
+        for (size_t i=0 ; i<v.size() ; ++i) {
+            Set.insert(v[i]);
+        }
+    });
+    std::ostringstream bulk;
+    bulk << "btree::btree_set" << suffix << " bulk_load(" << fill << ")";
+    addBuild< btree::btree_set<T> >(runner, bulk.str(), sorted, [fill](btree::btree_set<T>& Set, const std::vector<T>& v) {
+        Set.bulk_load(v.begin(), v.end(), fill);
+    });
+    addBuild< boost::container::flat_set<T> >(runner, "boost::container::flat_set" + suffix + " ordered_unique_range", sorted, [](boost::container::flat_set<T>& Set, const std::vector<T>& v) {
+        Set.insert(boost::container::ordered_unique_range, v.begin(), v.end());
+    });
+    addBuild< std::set<T> >(runner, "std::set" + suffix + " hint", sorted, [](std::set<T>& Set, const std::vector<T>& v) {
+        for (size_t i=0 ; i<v.size() ; ++i) {
+            Set.insert(Set.end(), v[i]);
+        }
+    });
+
+    runner.n = n;
+    runner.size = 0;
+    std::vector<bench::Result> timings = runner.run();
+    if (timings.empty()) {
+        return;
+    }
+    std::cout << "<" << w.type << "> from sorted\tns/element" << std::endl;
+    for (size_t i=0 ; i<timings.size() ; ++i) {
+        double ns = runner.calibration().to_ns(timings[i].fastest) / double(timings[i].n ? timings[i].n : 1);
+        std::cout << timings[i].name << "\t" << std::setprecision(2) << ns << std::endl;
+    }
     std::cout << std::endl;
+}
+
+// Times a read-only lookup structure: building it from the sorted keys, then
+// looking up and iterating like runTest() does
+template<typename Cont, typename T, typename Build>
+void staticTest(bench::Runner& runner, const Workload& w, const std::string& name, const Keys<T>& keys, const std::vector<T>& sorted, Build build) {
+    std::vector<std::string> phases = {"build", "lookup", "iterate"};
+    if (!keys.misses.empty()) {
+        phases.push_back("miss lookup");
+        phases.push_back("mixed lookup");
+    }
+    runner.add(name + "<" + w.type + ">" + w.keys + " read-only", phases, [&keys, &sorted, build](bench::Timer& t) {
+        size_t heap = bench::heap_in_use();
+        Cont Set;
+        t.start();
+        build(Set, sorted);
+        t.stop(0);
+        size_t used = bench::heap_in_use();
+        t.working_set(used > heap ? used - heap : 0);
+
+        t.start();
+        size_t res = lookup(Set, keys.values);
+        t.stop(1);
+        bench::keep(res);
+
+        res = 0;
+        t.start();
+        for (typename Cont::const_iterator it = Set.begin(); it != Set.end() ; ++it) {
+            res += checkvalue(*it);
+        }
+        t.stop(2);
+        bench::keep(res);
+
+        if (!keys.misses.empty()) {
+            t.start();
+            res = lookup(Set, keys.misses);
+            t.stop(3);
+            bench::keep(res);
+
+            t.start();
+            res = lookup(Set, keys.queries);
+            t.stop(4);
+            bench::keep(res);
+        }
+    });
 
-    std::cout << name << " iterate: ";
-    timings[2][0] = PrintStats(timings[2]);
+    std::vector<bench::Result> timings = runner.run();
+    if (timings.empty()) {
+        return;
+    }
+    std::cout << name << std::fixed << std::setprecision(0);
+    for (size_t i=0 ; i<timings.size() ; ++i) {
+        std::cout << "\t" << timings[i].fastest;
+    }
     std::cout << std::endl;
+}
+
+// Reference tables rebuilt now and then and read all the time: the sorted
+// arrays binary searched by sorted_vector and flat_set, the bulk loaded
+// btree_set, and the Eytzinger and static B+ tree layouts
+template<typename T>
+void staticTests(bench::Runner& runner, const Workload& w, const Keys<T>& keys, const std::string& columns) {
+    std::vector<T> sorted(keys.values);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    std::cout << "<" << w.type << "> read-only" << columns << std::endl;
 
-    std::cout << name << " erase: ";
-    timings[3][0] = PrintStats(timings[3]);
+    staticTest< CG3::sorted_vector<T> >(runner, w, "CG3::sorted_vector", keys, sorted, [](CG3::sorted_vector<T>& Set, const std::vector<T>& v) {
+        for (size_t i=0 ; i<v.size() ; ++i) {
+            Set.insert(v[i]);
+        }
+    });
+    staticTest< boost::container::flat_set<T> >(runner, w, "boost::container::flat_set", keys, sorted, [](boost::container::flat_set<T>& Set, const std::vector<T>& v) {
+        Set.insert(boost::container::ordered_unique_range, v.begin(), v.end());
+    });
+    staticTest< btree::btree_set<T> >(runner, w, "btree::btree_set", keys, sorted, [](btree::btree_set<T>& Set, const std::vector<T>& v) {
+        Set.bulk_load(v.begin(), v.end());
+    });
+    staticTest< bench::eytzinger_set<T> >(runner, w, "bench::eytzinger_set", keys, sorted, [](bench::eytzinger_set<T>& Set, const std::vector<T>& v) {
+        Set.assign(v.begin(), v.end());
+    });
+    staticTest< bench::static_btree_set<T> >(runner, w, "bench::static_btree_set", keys, sorted, [](bench::static_btree_set<T>& Set, const std::vector<T>& v) {
+        Set.assign(v.begin(), v.end());
+    });
     std::cout << std::endl;
+}
+
+// The TargetNodeSize values -p nodes= can pick from
+const size_t node_sizes[] = { 64, 128, 256, 512, 1024, 4096 };
+
+template<int Size, typename T>
+void nodeSizeTest(bench::Runner& runner, const Workload& w, const Keys<T>& keys, const std::vector<size_t>& nodes) {
+    if (std::find(nodes.begin(), nodes.end(), size_t(Size)) != nodes.end()) {
+        runTest< sized_btree_set<T, Size>, counted_sized_btree_set<T, Size> >(runner, w, "btree::btree_set[" + std::to_string(Size) + "]", keys);
+    }
+}
+
+// btree_set at each requested node size, with fullness and overhead from the
+// counted instance in the memory line
+template<typename T>
+void nodeSizeTests(bench::Runner& runner, const Workload& w, const Keys<T>& keys, const std::vector<size_t>& nodes) {
+    nodeSizeTest<64>(runner, w, keys, nodes);
+    nodeSizeTest<128>(runner, w, keys, nodes);
+    nodeSizeTest<256>(runner, w, keys, nodes);
+    nodeSizeTest<512>(runner, w, keys, nodes);
+    nodeSizeTest<1024>(runner, w, keys, nodes);
+    nodeSizeTest<4096>(runner, w, keys, nodes);
+}
+
+struct ThreadMix {
+    std::string name;
+    bench::OpMix mix;
+};
+
+// Threads replaying their own traces of an operation mix against one shared
+// container preloaded with the first half of the keys. The threads split N
+// operations between them, so perfect scaling halves the time per doubling.
+template<typename Cont, typename T>
+void threadTest(bench::Runner& runner, const Workload& w, const std::string& name, const std::vector<T>& values, const std::vector<size_t>& threads, const std::vector<ThreadMix>& mixes) {
+    const size_t N = values.size();
+    const std::string kernel = name + "<" + w.type + ">" + w.keys;
+    // Kept here until runner.run() below is done with the kernels using them
+    std::vector< std::vector< std::vector<bench::Op> > > traces;
+    traces.reserve(mixes.size() * threads.size());
+    for (size_t m=0 ; m<mixes.size() ; ++m) {
+        for (size_t ti=0 ; ti<threads.size() ; ++ti) {
+            const size_t count = threads[ti];
+            traces.push_back(std::vector< std::vector<bench::Op> >(count));
+            std::vector< std::vector<bench::Op> >& trace = traces.back();
+            for (size_t i=0 ; i<count ; ++i) {
+                trace[i] = mixes[m].mix.trace(N, N / count + (i < N % count), 902200987 + i);
+            }
+            runner.add(kernel + " " + mixes[m].name + " threads=" + std::to_string(count), {""}, [&values, &trace](bench::Timer& t) {
+                const size_t N = values.size();
+                Cont Set;
+                for (size_t i=0 ; i<N/2 ; ++i) {
+                    Set.insert(values[i]);
+                }
+                std::atomic<size_t> res(0);
+                bench::run_threads(trace.size(), [&](size_t i) {
+                    res += bench::replay_shared<false>(Set, values, trace[i]);
+                }, &t);
+                bench::keep(res.load());
+            });
+        }
+    }
 
-	std::cout << std::fixed << std::setprecision(0);
-	std::cout << name << "\t" << timings[0][0] << "\t" << timings[1][0] << "\t" << timings[2][0] << "\t" << timings[3][0] << std::endl;
+    std::vector<bench::Result> timings = runner.run();
+    if (timings.empty()) {
+        return;
+    }
+    const bench::Clock& clock = runner.calibration();
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i=0 ; i<timings.size() ; ) {
+        const std::string mix = timings[i].name.substr(0, timings[i].name.rfind(" threads="));
+        std::cout << name << mix.substr(kernel.size());
+        for ( ; i<timings.size() && timings[i].name.compare(0, mix.size(), mix) == 0 ; ++i) {
+            std::cout << "\t" << double(timings[i].n) / clock.to_ns(timings[i].fastest) * 1e3;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
 
+// Shared sets under read-mostly and write-heavy mixes at each thread count,
+// in Mops/s: std::set and btree_set behind a lock against the lock-free
+// readers of olc_btree_set
+template<typename T>
+void threadTests(bench::Runner& runner, const Workload& w, const std::vector<T>& values, const std::vector<size_t>& threads, const std::vector<ThreadMix>& mixes) {
+    std::cout << "<" << w.type << "> shared\tMops/s at threads";
+    for (size_t i=0 ; i<threads.size() ; ++i) {
+        std::cout << "\t" << threads[i];
+    }
     std::cout << std::endl;
+    threadTest< bench::locked_set< std::set<T> > >(runner, w, "std::set[mutex]", values, threads, mixes);
+    threadTest< bench::locked_set< btree::btree_set<T>, std::shared_mutex > >(runner, w, "btree::btree_set[shared_mutex]", values, threads, mixes);
+    threadTest< btree::olc_btree_set<T> >(runner, w, "btree::olc_btree_set", values, threads, mixes);
 }
 
-int main() {
-    srand(902200987);
-    std::vector<uint32_t> numbers;
-    std::vector<std::string> strings;
+void toStrings(const std::vector<uint32_t>& numbers, std::vector<std::string>& strings) {
+    strings.reserve(numbers.size());
     std::ostringstream ss;
-    for (size_t i=0 ; i<N ; ++i) {
+    for (size_t i=0 ; i<numbers.size() ; ++i) {
         ss.clear();
         ss.str("");
-        int rnd = rand() & 0x00003FFF;
-        ss << rnd;
+        ss << numbers[i];
         strings.push_back(ss.str());
-        numbers.push_back(rnd);
-    }
-
-    std::cout << "<uint32_t>\tInsert\tLookup\tIterate\tErase" << std::endl;
-    runTest< std::set<uint32_t> >("std::set", numbers);
-    runTest< std::unordered_set<uint32_t> >("std::unordered_set", numbers);
-    runTest< boost::unordered_set<uint32_t> >("boost::unordered_set", numbers);
-    runTest< CG3::interval_vector<uint32_t> >("CG3::interval_vector", numbers);
-    runTest< CG3::sorted_vector<uint32_t> >("CG3::sorted_vector", numbers);
-    //runTest< CG3::sorted_deque<uint32_t> >("CG3::sorted_deque", numbers);
-    runTest< btree::btree_set<uint32_t> >("btree::btree_set", numbers);
-    //runTest< btree::safe_btree_set<uint32_t> >("btree::safe_btree_set", numbers);
+    }
+}
+
+// Benchmark specific settings:
+//  -p keys=LIST  key distributions to run, see workloads.hpp
+//  -p mix=SPEC   also replay an interleaved operation trace per container,
+//                e.g. lookup:90,insert:8,erase:2,skew:0.99 ("default" is that)
+//  -p hits=R     also time lookups of keys that were never inserted, and N
+//                lookups of which the fraction R hit, e.g. 0.05
+//  -p ranges=LIST  also time N/S range queries of S elements each for every
+//                S in LIST on ordered containers ("default" is 1,100,10k)
+//  -p build=FILL also time building trees from the sorted keys, bulk loading
+//                btree_set with nodes FILL full, e.g. 1 or 0.7
+//  -p static=1   also time read-only sets built from the sorted keys,
+//                against binary searched sorted arrays
+//  -p nodes=LIST also run btree_set at these TargetNodeSize bytes, out of
+//                64,128,256,512,1024,4096 ("all" is every one of them)
+//  -p threads=LIST  also share uint32_t sets between each number of threads
+//                in LIST, e.g. 1..64 ("all" is powers of 2 up to the number
+//                of hardware threads), replaying the -p mix= operations or
+//                else a read-mostly and a write-heavy mix; leave out --cpu,
+//                which the threads would inherit
+int main(int argc, char *argv[]) {
+    bench::Runner runner(argc, argv);
+    std::vector<bench::KeyDistribution> dists;
+    bench::OpMix mix;
+    const std::string mix_spec = runner.param("mix", "");
+    const std::string hits_spec = runner.param("hits", "");
+    double hits = 0.0;
+    std::string ranges_spec = runner.param("ranges", "");
+    std::vector<size_t> spans;
+    const std::string build_spec = runner.param("build", "");
+    double fill = 1.0;
+    const std::string static_spec = runner.param("static", "");
+    const std::string nodes_spec = runner.param("nodes", "");
+    std::vector<size_t> nodes;
+    const std::string threads_spec = runner.param("threads", "");
+    std::vector<size_t> threads;
+    std::vector<ThreadMix> thread_mixes;
+    try {
+        dists = bench::KeyDistribution::parse_list(runner.param("keys", "dense"));
+        if (!mix_spec.empty() && mix_spec != "default") {
+            mix = bench::OpMix::parse(mix_spec);
+        }
+        if (!hits_spec.empty()) {
+            char *end = 0;
+            hits = std::strtod(hits_spec.c_str(), &end);
+            if (*end || !(hits >= 0.0 && hits <= 1.0)) {
+                throw std::invalid_argument("hit ratio must be between 0 and 1: " + hits_spec);
+            }
+        }
+        if (ranges_spec == "default") {
+            ranges_spec = "1,100,10k";
+        }
+        if (!ranges_spec.empty()) {
+            spans = bench::parse_sizes(ranges_spec);
+        }
+        if (!build_spec.empty()) {
+            char *end = 0;
+            fill = std::strtod(build_spec.c_str(), &end);
+            if (*end || !(fill > 0.0 && fill <= 1.0)) {
+                throw std::invalid_argument("fill factor must be above 0 and at most 1: " + build_spec);
+            }
+        }
+        if (!static_spec.empty() && static_spec != "0" && static_spec != "1") {
+            throw std::invalid_argument("static must be 0 or 1: " + static_spec);
+        }
+        const size_t *nodes_end = node_sizes + sizeof(node_sizes) / sizeof(node_sizes[0]);
+        if (nodes_spec == "all") {
+            nodes.assign(node_sizes, nodes_end);
+        }
+        else if (!nodes_spec.empty()) {
+            nodes = bench::parse_sizes(nodes_spec);
+        }
+        for (size_t i=0 ; i<nodes.size() ; ++i) {
+            if (std::find(node_sizes, nodes_end, nodes[i]) == nodes_end) {
+                throw std::invalid_argument("no btree_set instance with TargetNodeSize " + std::to_string(nodes[i]));
+            }
+        }
+        if (threads_spec == "all") {
+            const size_t hw = std::max<size_t>(1, std::thread::hardware_concurrency());
+            for (size_t t=1 ; t<hw ; t *= 2) {
+                threads.push_back(t);
+            }
+            threads.push_back(hw);
+        }
+        else if (!threads_spec.empty()) {
+            threads = bench::parse_sizes(threads_spec);
+            if (std::find(threads.begin(), threads.end(), size_t(0)) != threads.end()) {
+                throw std::invalid_argument("thread counts must be at least 1: " + threads_spec);
+            }
+        }
+        if (!mix_spec.empty() && mix_spec != "default") {
+            ThreadMix m = { "mix", mix };
+            thread_mixes.push_back(m);
+        }
+        else {
+            ThreadMix read = { "read", bench::OpMix::parse("lookup:95,insert:4,erase:1,skew:0") };
+            ThreadMix write = { "write", bench::OpMix::parse("lookup:50,insert:25,erase:25,skew:0") };
+            thread_mixes.push_back(read);
+            thread_mixes.push_back(write);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (!threads.empty()) {
+        runner.threaded();
+    }
+    std::vector<size_t> sizes = runner.sizes(1000000);
+    for (size_t di=0 ; di<dists.size() ; ++di) {
+        for (size_t si=0 ; si<sizes.size() ; ++si) {
+            const size_t N = sizes[si];
+            runner.n = N;
+
+            // The default dense keys are distinguished from the others in the
+            // kernel names only by their absence, so old results still compare
+            Workload w32;
+            w32.type = "uint32_t";
+            w32.keys = (dists[di].name == "dense") ? "" : "[" + dists[di].str() + "]";
+            if (!mix_spec.empty()) {
+                w32.trace = mix.trace(N, N);
+            }
+            // The string keys are the decimal forms of the numbers, so misses
+            // stay misses and queries hit and miss alike for both
+            Keys<uint32_t> numbers;
+            numbers.values = dists[di].generate<uint32_t>(N);
+            if (!hits_spec.empty()) {
+                numbers.misses = dists[di].absent(numbers.values, N);
+                numbers.queries = bench::mix_queries(numbers.values, numbers.misses, hits, N);
+            }
+            Keys<std::string> strings;
+            toStrings(numbers.values, strings.values);
+            toStrings(numbers.misses, strings.misses);
+            toStrings(numbers.queries, strings.queries);
+            // Spans with no windows, as wide as the distinct keys or wider,
+            // get no range kernel rather than one labelled with the wrong span
+            for (size_t r=0 ; r<spans.size() ; ++r) {
+                const size_t queries = std::max<size_t>(1, N / std::max<size_t>(1, spans[r]));
+                std::vector< std::pair<uint32_t, uint32_t> > windows = bench::range_windows(numbers.values, spans[r], queries);
+                if (windows.empty()) {
+                    continue;
+                }
+                numbers.windows.push_back(windows);
+                strings.windows.push_back(bench::range_windows(strings.values, spans[r], queries));
+                w32.spans.push_back(spans[r]);
+            }
+            Workload wstr = w32;
+            wstr.type = "std::string";
+
+            if (sizes.size() > 1 || dists.size() > 1) {
+                std::cout << "N = " << N << ", keys " << dists[di].str() << std::endl;
+            }
+            if (!mix_spec.empty()) {
+                std::cout << "mix " << mix.str() << std::endl;
+            }
+            std::string hit_columns;
+            if (!hits_spec.empty()) {
+                std::ostringstream ss;
+                ss << "\tMiss\t" << hits * 100.0 << "% hits";
+                hit_columns = ss.str();
+            }
+            std::string columns = "\tInsert\tLookup\tIterate\tErase" + hit_columns;
+            std::cout << "<uint32_t>" << columns << std::endl;
+            runTest< std::set<uint32_t>, counted_set<uint32_t> >(runner, w32, "std::set", numbers);
+            runTest< std::unordered_set<uint32_t>, counted_unordered_set<uint32_t> >(runner, w32, "std::unordered_set", numbers);
+            runTest< boost::unordered_set<uint32_t>, counted_boost_unordered_set<uint32_t> >(runner, w32, "boost::unordered_set", numbers);
+            runTest< bench::flat_hash_set<uint32_t>, counted_flat_hash_set<uint32_t> >(runner, w32, "bench::flat_hash_set", numbers);
+            runTest< bench::robin_hood_set<uint32_t>, counted_robin_hood_set<uint32_t> >(runner, w32, "bench::robin_hood_set", numbers);
+            runTest< CG3::interval_vector<uint32_t> >(runner, w32, "CG3::interval_vector", numbers);
+            runTest< CG3::sorted_vector<uint32_t> >(runner, w32, "CG3::sorted_vector", numbers);
+            //runTest< CG3::sorted_deque<uint32_t> >(runner, w32, "CG3::sorted_deque", numbers);
+            runTest< btree::btree_set<uint32_t>, counted_btree_set<uint32_t> >(runner, w32, "btree::btree_set", numbers);
+            runTest< search_btree_set<uint32_t, btree::btree_binary_search> >(runner, w32, "btree::btree_set[binary]", numbers);
+            runTest< search_btree_set<uint32_t, btree::btree_simd_search> >(runner, w32, "btree::btree_set[simd]", numbers);
+            runTest< prefetch_btree_set<uint32_t> >(runner, w32, "btree::btree_set[prefetch]", numbers);
+            runTest< arena_btree_set<uint32_t> >(runner, w32, "btree::btree_set[arena]", numbers);
+            //runTest< btree::safe_btree_set<uint32_t> >(runner, w32, "btree::safe_btree_set", numbers);
 #ifdef _MSC_VER
-    runTest< sti::sset<uint32_t> >("sti::sset", numbers);
+            runTest< sti::sset<uint32_t> >(runner, w32, "sti::sset", numbers);
 #else
-	runTest< boost::container::flat_set<uint32_t> >("boost::container::flat_set", numbers); // Broken Boost 1.55.0 vs. VS12?
+            runTest< boost::container::flat_set<uint32_t>, counted_flat_set<uint32_t> >(runner, w32, "boost::container::flat_set", numbers); // Broken Boost 1.55.0 vs. VS12?
 #endif
+            nodeSizeTests(runner, w32, numbers, nodes);
 
-    std::cout << "<std::string>\tInsert\tLookup\tIterate\tErase" << std::endl;
-    runTest< std::set<std::string> >("std::set", strings);
-    runTest< std::unordered_set<std::string> >("std::unordered_set", strings);
-    runTest< boost::unordered_set<std::string> >("boost::unordered_set", strings);
-    //runTest< CG3::interval_vector<std::string> >("CG3::interval_vector", strings); // only makes sense for integers
-    runTest< CG3::sorted_vector<std::string> >("CG3::sorted_vector", strings);
-    //runTest< CG3::sorted_deque<std::string> >("CG3::sorted_deque", strings);
-    runTest< tdc::trie<std::string> >("tdc::trie", strings);
-    runTest< btree::btree_set<std::string> >("btree::btree_set", strings);
-    //runTest< btree::safe_btree_set<std::string> >("btree::safe_btree_set", strings);
+            std::cout << "<std::string>" << columns << std::endl;
+            runTest< std::set<std::string>, counted_set<std::string> >(runner, wstr, "std::set", strings);
+            runTest< std::unordered_set<std::string>, counted_unordered_set<std::string> >(runner, wstr, "std::unordered_set", strings);
+            runTest< boost::unordered_set<std::string>, counted_boost_unordered_set<std::string> >(runner, wstr, "boost::unordered_set", strings);
+            runTest< bench::flat_hash_set<std::string>, counted_flat_hash_set<std::string> >(runner, wstr, "bench::flat_hash_set", strings);
+            runTest< bench::robin_hood_set<std::string>, counted_robin_hood_set<std::string> >(runner, wstr, "bench::robin_hood_set", strings);
+            //runTest< CG3::interval_vector<std::string> >(runner, wstr, "CG3::interval_vector", strings); // only makes sense for integers
+            runTest< CG3::sorted_vector<std::string> >(runner, wstr, "CG3::sorted_vector", strings);
+            //runTest< CG3::sorted_deque<std::string> >(runner, wstr, "CG3::sorted_deque", strings);
+            runTest< tdc::trie<std::string> >(runner, wstr, "tdc::trie", strings);
+            runTest< btree::btree_set<std::string>, counted_btree_set<std::string> >(runner, wstr, "btree::btree_set", strings);
+            runTest< prefetch_btree_set<std::string> >(runner, wstr, "btree::btree_set[prefetch]", strings);
+            runTest< arena_btree_set<std::string> >(runner, wstr, "btree::btree_set[arena]", strings);
+            //runTest< btree::safe_btree_set<std::string> >(runner, wstr, "btree::safe_btree_set", strings);
 #ifdef _MSC_VER
-    runTest< sti::sset<std::string> >("sti::sset", strings);
+            runTest< sti::sset<std::string> >(runner, wstr, "sti::sset", strings);
 #else
-	runTest< boost::container::flat_set<std::string> >("boost::container::flat_set", strings); // Broken Boost 1.55.0 vs. VS12?
+            runTest< boost::container::flat_set<std::string>, counted_flat_set<std::string> >(runner, wstr, "boost::container::flat_set", strings); // Broken Boost 1.55.0 vs. VS12?
 #endif
+            nodeSizeTests(runner, wstr, strings, nodes);
+
+            if (static_spec == "1") {
+                staticTests(runner, w32, numbers, "\tBuild\tLookup\tIterate" + hit_columns);
+                staticTests(runner, wstr, strings, "\tBuild\tLookup\tIterate" + hit_columns);
+            }
+
+            if (!build_spec.empty()) {
+                buildTest(runner, w32, numbers.values, fill);
+                buildTest(runner, wstr, strings.values, fill);
+            }
+            if (!threads.empty()) {
+                threadTests(runner, w32, numbers.values, threads, thread_mixes);
+            }
+        }
+    }
+    runner.curve();
 }
@@ -17,8 +17,7 @@
 * along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <cycle.h>
-#include <helpers.hpp>
+#include <bench.hpp>
 
 #include <cstdlib>
 #include <cstdio>
@@ -34,9 +33,6 @@
 #include <iomanip>
 #include <stdint.h>
 
-static const size_t N = 1000000;
-static const size_t R = 7;
-
 inline bool naive_char(const char *a, const char *b) {
 	while (*a || *b) {
 		if (*a != *b) {
@@ -55,238 +51,122 @@ inline bool naive_string(const std::string& a, const std::string& b) {
 	return false;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
 	setlocale(LC_ALL, "C");
+	bench::Runner runner(argc, argv);
+	for (size_t n : runner.sizes(1000000)) {
+		const size_t N = n;
+		runner.n = N - 1;
+
+		size_t heap = bench::heap_in_use();
+		std::vector<const char*> chars;
+        std::vector<std::string> strings;
+        chars.reserve(N);
+        strings.reserve(N);
+        for (size_t i=0 ; i<N ; ++i) {
+            char *s = new char[12];
+            sprintf(s, "%u", uint32_t(i));
+            chars.push_back(s);
+            strings.push_back(s);
+            strings.back().c_str();
+        }
+        runner.working_set = bench::heap_in_use() - heap;
 
-	std::vector<const char*> chars;
-    std::vector<std::string> strings;
-    chars.reserve(N);
-    strings.reserve(N);
-    for (size_t i=0 ; i<N ; ++i) {
-        char *s = new char[12];
-        sprintf(s, "%u", uint32_t(i));
-        chars.push_back(s);
-        strings.push_back(s);
-        strings.back().c_str();
-    }
-
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
+        runner.add("naive(char*,char*)", [&]() {
+            size_t tlen = 0;
             for (size_t i=1 ; i<N ; ++i) {
                 if (naive_char(chars[i], chars[i-1])) {
                     ++tlen;
                 }
             }
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "naive(char*,char*): ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
+            bench::keep(tlen);
+        });
 
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
+        runner.add("naive(string,string)", [&]() {
+            size_t tlen = 0;
             for (size_t i=1 ; i<N ; ++i) {
                 if (naive_string(strings[i], strings[i-1])) {
                     ++tlen;
                 }
             }
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
+            bench::keep(tlen);
+        });
 
-        std::cout << "naive(string,string): ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
-
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
+        runner.add("string == string", [&]() {
+            size_t tlen = 0;
             for (size_t i=1 ; i<N ; ++i) {
                 if (strings[i] == strings[i-1]) {
                     ++tlen;
                 }
             }
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "string == string: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
+            bench::keep(tlen);
+        });
 
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
+        runner.add("string == char*", [&]() {
+            size_t tlen = 0;
             for (size_t i=1 ; i<N ; ++i) {
                 if (strings[i] == chars[i-1]) {
                     ++tlen;
                 }
             }
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "string == char*: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
+            bench::keep(tlen);
+        });
 
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
+        runner.add("strcmp(char*,char*) == 0", [&]() {
+            size_t tlen = 0;
             for (size_t i=1 ; i<N ; ++i) {
                 if (strcmp(chars[i], chars[i-1]) == 0) {
                     ++tlen;
                 }
             }
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "strcmp(char*,char*) == 0: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
+            bench::keep(tlen);
+        });
 
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
+        runner.add("strcmp(char*,string.c_str()) == 0", [&]() {
+            size_t tlen = 0;
             for (size_t i=1 ; i<N ; ++i) {
                 if (strcmp(chars[i], strings[i-1].c_str()) == 0) {
                     ++tlen;
                 }
             }
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
+            bench::keep(tlen);
+        });
 
-        std::cout << "strcmp(char*,string.c_str()) == 0: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
-
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
+        runner.add("strcmp(string.c_str(),string.c_str()) == 0", [&]() {
+            size_t tlen = 0;
             for (size_t i=1 ; i<N ; ++i) {
                 if (strcmp(strings[i].c_str(), strings[i-1].c_str()) == 0) {
                     ++tlen;
                 }
             }
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "strcmp(string.c_str(),string.c_str()) == 0: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
+            bench::keep(tlen);
+        });
 
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
+        runner.add("string.compare(string) == 0", [&]() {
+            size_t tlen = 0;
             for (size_t i=1 ; i<N ; ++i) {
                 if (strings[i].compare(strings[i-1]) == 0) {
                     ++tlen;
                 }
             }
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
-
-        std::cout << "string.compare(string) == 0: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
+            bench::keep(tlen);
+        });
 
-//*
-    {
-        size_t tlen = 0;
-        std::vector<double> timings;
-        timings.reserve(R);
-        for (size_t r=0 ; r<R ; ++r) {
-            ticks start = getticks();
+        runner.add("string.compare(char*) == 0", [&]() {
+            size_t tlen = 0;
             for (size_t i=1 ; i<N ; ++i) {
                 if (strings[i].compare(chars[i-1]) == 0) {
                     ++tlen;
                 }
             }
-            ticks end = getticks();
-            double timed = elapsed(end, start);
-            timings.push_back(timed);
-        }
+            bench::keep(tlen);
+        });
 
-        std::cout << "string.compare(char*) == 0: ";
-        PrintStats(timings);
-        std::cout << std::endl;
-        std::cout << tlen << std::endl;
-    }
-//*/
+        runner.run();
 
-	for (size_t i=0 ; i<N ; ++i) {
-    	delete[] chars[i];
-    }
+		for (size_t i=0 ; i<N ; ++i) {
+        	delete[] chars[i];
+        }
+	}
+	runner.curve();
 }
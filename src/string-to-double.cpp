@@ -17,8 +17,7 @@
 * along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <cycle.h>
-#include <helpers.hpp>
+#include <bench.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/spirit/include/qi.hpp>
 #include <boost/spirit/include/phoenix_core.hpp>
@@ -35,9 +34,6 @@
 #include <iomanip>
 #include <sstream>
 
-static const size_t N = 100000;
-static const size_t R = 7;
-
 double naive(const char *p) {
 	double r = 0.0;
 	bool neg = false;
@@ -66,180 +62,99 @@ double naive(const char *p) {
 	return r;
 }
 
-int main() {
-	std::vector<std::string> nums;
-	nums.reserve(N);
-	for (size_t i = 0; i < N; ++i) {
-		std::string y;
-		if (i & 1) {
-			y += '-';
+int main(int argc, char *argv[]) {
+	bench::Runner runner(argc, argv);
+	for (size_t n : runner.sizes(100000)) {
+		const size_t N = n;
+		runner.n = N;
+
+		size_t heap = bench::heap_in_use();
+		std::vector<std::string> nums;
+		nums.reserve(N);
+		for (size_t i = 0; i < N; ++i) {
+			std::string y;
+			if (i & 1) {
+				y += '-';
+			}
+			y += boost::lexical_cast<std::string>(i);
+			y += '.';
+			y += boost::lexical_cast<std::string>(i);
+			nums.push_back(y);
 		}
-		y += boost::lexical_cast<std::string>(i);
-		y += '.';
-		y += boost::lexical_cast<std::string>(i);
-		nums.push_back(y);
-	}
+		runner.working_set = bench::heap_in_use() - heap;
 
-	{
-		double tsum = 0.0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("naive", [&]() {
+			double tsum = 0.0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				double x = naive(nums[i].c_str());
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "naive: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		double tsum = 0.0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("atof()", [&]() {
+			double tsum = 0.0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				double x = atof(nums[i].c_str());
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "atof(): ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		double tsum = 0.0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("strtod()", [&]() {
+			double tsum = 0.0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				double x = strtod(nums[i].c_str(), 0);
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "strtod(): ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		double tsum = 0.0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("sscanf()", [&]() {
+			double tsum = 0.0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				double x = 0.0;
 				sscanf(nums[i].c_str(), "%lf", &x);
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "sscanf(): ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		double tsum = 0.0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("lexical_cast", [&]() {
+			double tsum = 0.0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				double x = boost::lexical_cast<double>(nums[i]);
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "lexical_cast: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		using boost::spirit::qi::double_;
-		using boost::spirit::qi::parse;
-		double tsum = 0.0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("spirit qi", [&]() {
+			using boost::spirit::qi::double_;
+			using boost::spirit::qi::parse;
+			double tsum = 0.0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				double x = 0.0;
 				char const *str = nums[i].c_str();
 				parse(str, &str[nums[i].size()], double_, x);
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "spirit qi: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		double tsum = 0.0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("stringstream", [&]() {
+			double tsum = 0.0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				std::istringstream ss(nums[i]);
 				double x = 0.0;
 				ss >> x;
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "stringstream: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		double tsum = 0.0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("stringstream reused", [&]() {
+			double tsum = 0.0;
 			std::istringstream ss;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				ss.str(nums[i]);
@@ -248,14 +163,10 @@ int main() {
 				ss >> x;
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "stringstream reused: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
+		runner.run();
 	}
+	runner.curve();
 }
@@ -17,8 +17,7 @@
 * along with Benchmarks.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <cycle.h>
-#include <helpers.hpp>
+#include <bench.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/spirit/include/qi.hpp>
 #include <boost/spirit/include/phoenix_core.hpp>
@@ -35,9 +34,6 @@
 #include <iomanip>
 #include <sstream>
 
-static const int N = 100000;
-static const size_t R = 7;
-
 int naive(const char *p) {
 	int x = 0;
 	bool neg = false;
@@ -55,174 +51,93 @@ int naive(const char *p) {
 	return x;
 }
 
-int main() {
-	std::vector<std::string> nums;
-	nums.reserve(N);
-	for (int i = 0 - (N / 2); i < N / 2; ++i) {
-		std::string y = boost::lexical_cast<std::string>(i);
-		nums.push_back(y);
-	}
+int main(int argc, char *argv[]) {
+	bench::Runner runner(argc, argv);
+	for (size_t n : runner.sizes(100000)) {
+		const int N = int(n);
+		runner.n = N;
+
+		size_t heap = bench::heap_in_use();
+		std::vector<std::string> nums;
+		nums.reserve(N);
+		for (int i = 0 - (N / 2); i < N - (N / 2); ++i) {
+			std::string y = boost::lexical_cast<std::string>(i);
+			nums.push_back(y);
+		}
+		runner.working_set = bench::heap_in_use() - heap;
 
-	{
-		int tsum = 0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("naive", [&]() {
+			int tsum = 0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				int x = naive(nums[i].c_str());
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "naive: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		int tsum = 0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("atoi()", [&]() {
+			int tsum = 0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				int x = atoi(nums[i].c_str());
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "atoi(): ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		int tsum = 0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("strtol()", [&]() {
+			int tsum = 0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				int x = strtol(nums[i].c_str(), 0, 10);
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "strtol(): ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		int tsum = 0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("sscanf()", [&]() {
+			int tsum = 0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				int x = 0;
 				sscanf(nums[i].c_str(), "%d", &x);
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "sscanf(): ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		int tsum = 0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("lexical_cast", [&]() {
+			int tsum = 0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				int x = boost::lexical_cast<int>(nums[i]);
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "lexical_cast: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		using boost::spirit::qi::int_;
-		using boost::spirit::qi::parse;
-		int tsum = 0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("spirit qi", [&]() {
+			using boost::spirit::qi::int_;
+			using boost::spirit::qi::parse;
+			int tsum = 0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				int x = 0;
 				char const *str = nums[i].c_str();
 				parse(str, &str[nums[i].size()], int_, x);
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "spirit qi: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		int tsum = 0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("stringstream", [&]() {
+			int tsum = 0;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				std::istringstream ss(nums[i]);
 				int x = 0;
 				ss >> x;
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "stringstream: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
-	}
-
-	{
-		int tsum = 0;
-		std::vector<double> timings;
-		timings.reserve(R);
-		for (size_t r = 0; r < R; ++r) {
-			ticks start = getticks();
+		runner.add("stringstream reused", [&]() {
+			int tsum = 0;
 			std::istringstream ss;
 			for (size_t i = 0; i < nums.size(); ++i) {
 				ss.str(nums[i]);
@@ -231,14 +146,10 @@ int main() {
 				ss >> x;
 				tsum += x;
 			}
-			ticks end = getticks();
-			double timed = elapsed(end, start);
-			timings.push_back(timed);
-		}
+			bench::keep(tsum);
+		});
 
-		std::cout << "stringstream reused: ";
-		PrintStats(timings);
-		std::cout << std::endl;
-		std::cout << tsum << std::endl;
+		runner.run();
 	}
+	runner.curve();
 }